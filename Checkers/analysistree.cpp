@@ -0,0 +1,58 @@
+#include "analysistree.hpp"
+
+AnalysisTree::AnalysisTree()
+{
+    clear();
+}
+
+void AnalysisTree::clear()
+{
+    nodes.clear();
+    nodes.emplace_back();
+}
+
+quint32 AnalysisTree::findChild(const quint32 _parent, const Position::Move &_move) const
+{
+    for (auto child = nodes[_parent].firstChild; child != none; child = nodes[child].nextSibling) {
+        if(nodes[child].move == _move)
+            return child;
+    }
+    return none;
+}
+
+quint32 AnalysisTree::addChild(const quint32 _parent, const Position::Move &_move, bool *_created)
+{
+    auto id = findChild(_parent, _move);
+    if(_created)
+        *_created = id == none;
+    if(id != none)
+        return id;
+
+    id = size();
+    Node child;
+    child.move = _move;
+    child.parent = _parent;
+    child.row = nodes[_parent].childCount;
+    nodes.push_back(child);
+
+    auto& parent = nodes[_parent];
+    if(parent.lastChild == none)
+        parent.firstChild = id;
+    else
+        nodes[parent.lastChild].nextSibling = id;
+    parent.lastChild = id;
+    ++parent.childCount;
+    return id;
+}
+
+void AnalysisTree::setEvaluation(const quint32 _id, const int _score, const int _depth, const quint64 _nodes)
+{
+    auto& node = nodes[_id];
+    // Keep the deepest result seen for a node.
+    if(node.evaluated && node.depth > _depth)
+        return;
+    node.score = static_cast<qint16>(_score);
+    node.depth = static_cast<quint8>(_depth);
+    node.nodes = _nodes;
+    node.evaluated = true;
+}
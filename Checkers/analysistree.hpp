@@ -0,0 +1,43 @@
+#pragma once
+
+#include "position.hpp"
+
+#include <vector>
+
+// Flat, append-only store for explored variations. Children of a node form a singly linked
+// list in insertion order, so a node's row never changes once it has been added.
+class AnalysisTree
+{
+public:
+    static constexpr quint32 none = 0xFFFFFFFF;
+    static constexpr quint32 rootNode = 0;
+
+    struct Node
+    {
+        Position::Move move;
+        quint64 nodes = 0;
+        quint32 parent = none;
+        quint32 firstChild = none;
+        quint32 lastChild = none;
+        quint32 nextSibling = none;
+        quint32 childCount = 0;
+        quint32 row = 0;
+        qint16 score = 0;
+        quint8 depth = 0;
+        bool evaluated = false;
+    };
+
+    AnalysisTree();
+
+    void clear();
+    quint32 size() const { return static_cast<quint32>(nodes.size()); }
+    const Node& node(const quint32 _id) const { return nodes[_id]; }
+
+    quint32 findChild(const quint32 _parent, const Position::Move &_move) const;
+    // Returns the existing child for _move when there is one.
+    quint32 addChild(const quint32 _parent, const Position::Move &_move, bool *_created = nullptr);
+    void setEvaluation(const quint32 _id, const int _score, const int _depth, const quint64 _nodes);
+
+private:
+    std::vector<Node> nodes;
+};
@@ -1,228 +1,266 @@
-#include "cell.hpp"
-#include "checkerboard.hpp"
-
-#include <QPainter>
-#include <QDebug>
-#include <QKeyEvent>
-
-Cell::Cell(const int _row, const int _col, const QColor &_color, QWidget *_parent)
-    : QWidget(_parent)
-    , index(qMakePair(_row, _col))
-    , color(_color)
-    , prefferedSize(size())
-    , openedForMove(false)
-    , openedForJump(false)
-    , clickable(false)
-    , selected(false)
-    , backlight(false)
-{
-    setMinimumSize(64, 64);
-    QSizePolicy policy(this->sizePolicy());
-    policy.setVerticalPolicy(QSizePolicy::Preferred);
-    policy.setHorizontalPolicy(QSizePolicy::Preferred);
-    setSizePolicy(policy);
-    setFocusPolicy(Qt::ClickFocus);
-}
-
-Cell::Cell(const index_t &_index, const QColor &_color, QWidget *_parent)
-    : Cell(_index.first, _index.second, _color, _parent)
-{}
-
-QSize Cell::sizeHint() const
-{
-    auto size = qMin(prefferedSize.height(), prefferedSize.width());
-    return QSize(size, size);
-}
-
-void Cell::paintEvent(QPaintEvent *_event)
-{
-    QWidget::paintEvent(_event);
-
-    QPainter p(this);
-    p.setRenderHint(QPainter::RenderHint::HighQualityAntialiasing);
-    draw(&p);
-}
-
-void Cell::draw(QPainter *_painter)
-{
-    _painter->save();
-    _painter->setPen(QPen(Qt::transparent));
-
-    QRadialGradient grad(rect().center(), rect().width() / 2);
-    auto setupGradient = [&](const QColor &_mainColor) {
-        grad.setColorAt(0.15, _mainColor);
-        grad.setColorAt(0.3, color);
-        grad.setColorAt(0.55, _mainColor);
-        grad.setColorAt(0.7, color);
-        grad.setColorAt(0.9, _mainColor);
-        grad.setColorAt(1, color);
-    };
-
-    if(openedForJump) {
-        setupGradient(Qt::red);
-        _painter->setBrush(grad);
-    }
-    else if(openedForMove) {
-        setupGradient(Qt::green);
-        _painter->setBrush(grad);
-    }
-    else if(backlight) {
-        grad.setColorAt(0.9, Qt::green);
-        grad.setColorAt(1, color);
-        _painter->setBrush(grad);
-    }
-    else {
-        _painter->setBrush(color);
-    }
-    _painter->drawRect(rect());
-
-    if(checker) {
-        auto image = checker->getImage()->scaled(size());
-        _painter->drawPixmap(rect(), image);
-    }
-    _painter->restore();
-}
-
-void Cell::resizeEvent(QResizeEvent *_event)
-{
-    QWidget::resizeEvent(_event);
-
-    //temp
-    auto par = qobject_cast<Checkerboard*>(parentWidget());
-    if(par)
-        prefferedSize = par->size() / par->getBoardSize();
-    else
-        prefferedSize = QSize(64, 64);
-    updateGeometry();
-    //
-}
-
-void Cell::mousePressEvent(QMouseEvent *_event)
-{
-    QWidget::mousePressEvent(_event);
-
-    if(clickable) {
-        selected = !selected;
-        if(selected) {
-            if(openedForJump) {
-                emit checkerJumped(index);
-                return;
-            }
-            if (openedForMove) {
-                emit checkerMoved(index);
-                return;
-            }
-            backlight = true;
-            emit cellSelected(index);
-            return;
-        }
-        backlight = false;
-        emit cellDeselected();
-    }
-}
-
-void Cell::keyPressEvent(QKeyEvent *_event)
-{    
-    QWidget::keyPressEvent(_event);
-
-    if(selected) {
-        if(_event->key() == Qt::Key_Escape) {
-            selected = false;
-            backlight = false;
-            emit cellDeselected();
-        }
-    }
-}
-
-void Cell::moveCheckerTo(Cell *_destinationCell)
-{
-    checker->setIndex(_destinationCell->getIndex());
-    _destinationCell->setChecker(std::move(checker));
-}
-
-void Cell::moveCheckerTo(Cell *_destinationCell, Cell *_destructCell)
-{
-    moveCheckerTo(_destinationCell);
-    _destructCell->checker.reset();
-}
-
-void Cell::activate()
-{
-   clickable = true;
-}
-
-void Cell::deactivate()
-{
-    clickable = false;
-}
-
-void Cell::openForMove()
-{
-    openedForMove = true;
-    update();
-}
-
-void Cell::closeForMove()
-{
-    openedForMove = false;
-    update();
-}
-
-void Cell::openForJump()
-{
-    openedForJump = true;
-    update();
-}
-
-void Cell::closeForJump()
-{
-    openedForJump = false;
-    update();
-}
-
-bool Cell::isOpenForMove() const
-{
-    return openedForMove;
-}
-
-bool Cell::isOpenForJump() const
-{
-    return  openedForJump;
-}
-
-const Cell::index_t& Cell::getIndex() const
-{
-    return index;
-}
-
-void Cell::setBacklight(bool _value)
-{
-    backlight = _value;
-}
-
-bool Cell::isSelected() const
-{
-    return selected;
-}
-
-void Cell::setSelected(bool _value)
-{
-    selected = _value;
-}
-
-void Cell::setChecker(std::unique_ptr<Checker> &&_value)
-{
-    checker = std::move(_value);
-}
-
-bool Cell::hasChecker() const
-{
-    return checker.get();
-}
-
-const std::unique_ptr<Checker>& Cell::getChecker() const
-{
-    return checker;
-}
-
-
+#include "cell.hpp"
+#include "checkerboard.hpp"
+#include "trace.hpp"
+
+#include <QPainter>
+#include <QDebug>
+#include <QKeyEvent>
+#include <QElapsedTimer>
+
+Cell::Cell(const int _row, const int _col, const QColor &_color, QWidget *_parent)
+    : QWidget(_parent)
+    , index(qMakePair(_row, _col))
+    , color(_color)
+    , prefferedSize(size())
+    , openedForMove(false)
+    , openedForJump(false)
+    , clickable(false)
+    , selected(false)
+    , backlight(false)
+    , checkerHidden(false)
+    , paintDuration("checkers_cell_paint_seconds", "Time spent in Cell::paintEvent.",
+                    QByteArray("row=\"") + QByteArray::number(_row) + "\",col=\"" + QByteArray::number(_col) + '"')
+{
+    setMinimumSize(64, 64);
+    QSizePolicy policy(this->sizePolicy());
+    policy.setVerticalPolicy(QSizePolicy::Preferred);
+    policy.setHorizontalPolicy(QSizePolicy::Preferred);
+    setSizePolicy(policy);
+    setFocusPolicy(Qt::ClickFocus);
+}
+
+Cell::Cell(const index_t &_index, const QColor &_color, QWidget *_parent)
+    : Cell(_index.first, _index.second, _color, _parent)
+{}
+
+QSize Cell::sizeHint() const
+{
+    auto size = qMin(prefferedSize.height(), prefferedSize.width());
+    return QSize(size, size);
+}
+
+void Cell::paintEvent(QPaintEvent *_event)
+{
+    TRACE_SPAN("Cell::paintEvent");
+    QElapsedTimer timer;
+    timer.start();
+
+    QWidget::paintEvent(_event);
+
+    QPainter p(this);
+    p.setRenderHint(QPainter::RenderHint::HighQualityAntialiasing);
+    draw(&p);
+
+    paintDuration.observe(timer.nsecsElapsed());
+}
+
+void Cell::draw(QPainter *_painter)
+{
+    _painter->save();
+    _painter->setPen(QPen(Qt::transparent));
+
+    QRadialGradient grad(rect().center(), rect().width() / 2);
+    auto setupGradient = [&](const QColor &_mainColor) {
+        grad.setColorAt(0.15, _mainColor);
+        grad.setColorAt(0.3, color);
+        grad.setColorAt(0.55, _mainColor);
+        grad.setColorAt(0.7, color);
+        grad.setColorAt(0.9, _mainColor);
+        grad.setColorAt(1, color);
+    };
+
+    if(openedForJump) {
+        setupGradient(Qt::red);
+        _painter->setBrush(grad);
+    }
+    else if(openedForMove) {
+        setupGradient(Qt::green);
+        _painter->setBrush(grad);
+    }
+    else if(backlight) {
+        grad.setColorAt(0.9, Qt::green);
+        grad.setColorAt(1, color);
+        _painter->setBrush(grad);
+    }
+    else {
+        _painter->setBrush(color);
+    }
+    _painter->drawRect(rect());
+
+    if(checker && !checkerHidden) {
+        const auto& image = checker->getImage();
+        if(image && !image->isNull()) {
+            _painter->drawPixmap(rect(), image->scaled(size()));
+        }
+        else {
+            // Stand-in until the checker bitmaps have been decoded in the background.
+            _painter->setBrush(checker->getType() == Checker::Type::White ? Qt::lightGray : Qt::darkGray);
+            _painter->drawEllipse(rect().adjusted(width() / 8, height() / 8, -width() / 8, -height() / 8));
+        }
+    }
+    _painter->restore();
+}
+
+void Cell::resizeEvent(QResizeEvent *_event)
+{
+    QWidget::resizeEvent(_event);
+
+    //temp
+    auto par = qobject_cast<Checkerboard*>(parentWidget());
+    if(par)
+        prefferedSize = par->size() / par->getBoardSize();
+    else
+        prefferedSize = QSize(64, 64);
+    updateGeometry();
+    //
+}
+
+void Cell::mousePressEvent(QMouseEvent *_event)
+{
+    TRACE_SPAN("Cell::mousePressEvent");
+    QWidget::mousePressEvent(_event);
+
+    if(clickable) {
+        selected = !selected;
+        if(selected) {
+            if(openedForJump) {
+                TRACE_SPAN("Cell::checkerJumped");
+                emit checkerJumped(index);
+                return;
+            }
+            if (openedForMove) {
+                TRACE_SPAN("Cell::checkerMoved");
+                emit checkerMoved(index);
+                return;
+            }
+            backlight = true;
+            TRACE_SPAN("Cell::cellSelected");
+            emit cellSelected(index);
+            return;
+        }
+        backlight = false;
+        TRACE_SPAN("Cell::cellDeselected");
+        emit cellDeselected();
+    }
+}
+
+void Cell::keyPressEvent(QKeyEvent *_event)
+{    
+    QWidget::keyPressEvent(_event);
+
+    if(selected) {
+        if(_event->key() == Qt::Key_Escape) {
+            selected = false;
+            backlight = false;
+            emit cellDeselected();
+        }
+    }
+}
+
+void Cell::moveCheckerTo(Cell *_destinationCell)
+{
+    checker->setIndex(_destinationCell->getIndex());
+    _destinationCell->setChecker(std::move(checker));
+}
+
+void Cell::moveCheckerTo(Cell *_destinationCell, Cell *_destructCell)
+{
+    moveCheckerTo(_destinationCell);
+    _destructCell->checker.reset();
+}
+
+void Cell::activate()
+{
+   clickable = true;
+}
+
+void Cell::deactivate()
+{
+    clickable = false;
+}
+
+void Cell::openForMove()
+{
+    openedForMove = true;
+    update();
+}
+
+void Cell::closeForMove()
+{
+    openedForMove = false;
+    update();
+}
+
+void Cell::openForJump()
+{
+    openedForJump = true;
+    update();
+}
+
+void Cell::closeForJump()
+{
+    openedForJump = false;
+    update();
+}
+
+bool Cell::isOpenForMove() const
+{
+    return openedForMove;
+}
+
+bool Cell::isOpenForJump() const
+{
+    return  openedForJump;
+}
+
+const Cell::index_t& Cell::getIndex() const
+{
+    return index;
+}
+
+void Cell::setBacklight(bool _value)
+{
+    backlight = _value;
+}
+
+bool Cell::isActivated() const
+{
+    return clickable;
+}
+
+void Cell::setCheckerHidden(bool _value)
+{
+    checkerHidden = _value;
+}
+
+bool Cell::hasBacklight() const
+{
+    return backlight;
+}
+
+bool Cell::isSelected() const
+{
+    return selected;
+}
+
+void Cell::setSelected(bool _value)
+{
+    selected = _value;
+}
+
+void Cell::setChecker(std::unique_ptr<Checker> &&_value)
+{
+    checker = std::move(_value);
+}
+
+bool Cell::hasChecker() const
+{
+    return checker.get();
+}
+
+const std::unique_ptr<Checker>& Cell::getChecker() const
+{
+    return checker;
+}
+
+
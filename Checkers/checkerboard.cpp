@@ -1,301 +1,691 @@
-#include "checkerboard.hpp"
-#include <QPainter>
-#include <QPaintEvent>
-#include <QGridLayout>
-#include <QHBoxLayout>
-#include <QVBoxLayout>
-#include <QDebug>
-#include <QBitmap>
-
-Checkerboard::Checkerboard(const int _boardEdgeSize, QWidget *parent)
-    : QWidget(parent)
-    , mainLayout(new QGridLayout(this))
-    , oldSize(size())
-    , boardEdgeSize(_boardEdgeSize)
-{
-    initBoard();
-    setupLayout();
-    arrangeCheckers(Checker::Type::White, Checker::Type::Black);
-
-}
-
-void Checkerboard::resizeEvent(QResizeEvent *_event)
-{
-    QWidget::resizeEvent(_event);
-    checkAspectRatio();
-}
-
-void Checkerboard::initBoard()
-{
-    auto color = QColor(Qt::black);
-
-    cells.reserve(boardEdgeSize);
-    for (int row = 0; row < boardEdgeSize; ++row) {
-        cells.push_back(boardEdge_t());
-        cells[row].reserve(boardEdgeSize / 2);
-
-        for (int col = 0; col < boardEdgeSize / 2; ++col) {
-           auto cell = std::make_unique<Cell>(row, col, color, this);
-           setConnections(cell.get());
-           cells[row].push_back(std::move(cell));
-        }
-    }
-}
-
-void Checkerboard::setupLayout()
-{
-    mainLayout->setSpacing(0);
-    mainLayout->setAlignment(Qt::AlignHCenter);
-
-    if(!cells.empty()) {
-        int rowNum = 0;
-        for (const auto& row : cells) {
-            int colNum = 0;
-            int rowIndex = rowNum++;
-            for (const auto& cell : row) {
-                int colIndex = colNum++ * 2;
-                if(rowIndex % 2 != 0) {
-                    mainLayout->addWidget(cell.get(), rowIndex, colIndex);
-                }
-                else {
-                    mainLayout->addWidget(cell.get(), rowIndex, colIndex + 1);
-                }
-            }
-        }
-    }
-    setLayout(mainLayout);
-}
-
-void Checkerboard::checkAspectRatio()
-{
-    if((size().width() < size().height() && oldSize.width() > oldSize.height()) ||
-        (size().width() > size().height() && oldSize.width() < oldSize.height()))
-    {
-        oldSize = size();
-        changeLayoutAligment();
-    }
-}
-
-void Checkerboard::arrangeCheckers(Type _bottomPlayer, Type _topPlayer)
-{
-    auto arrange = [&](int _fromRow, int _toRow, QPixmap& _pixmap, Type _type, Checker::MoveDirection _direction) {
-        auto checkerImage = QSharedPointer<QPixmap>().create(_pixmap);
-        checkerImage->setMask(checkerImage->createMaskFromColor(Qt::white));
-
-        for(int row = _fromRow; row < _toRow; ++row) {
-            for (int col = 0; col < boardEdgeSize / 2; ++col) {
-                auto checker = std::make_unique<Checker>(row, col, checkerImage, _type, _direction);
-                setConnections(checker.get());
-                cells[row][col]->setChecker(std::move(checker));
-            }
-        }
-    };
-
-    //temp
-    QPixmap bottomPlayerPixmap;
-    QPixmap topPlayerPixmap;
-
-    if(_bottomPlayer == Type::White) {
-        bottomPlayerPixmap = QPixmap(":/qrc/resources/images/white checker.bmp");
-        topPlayerPixmap = QPixmap(":/qrc/resources/images/black checker.bmp");
-    }
-    else {
-        topPlayerPixmap = QPixmap(":/qrc/resources/images/white checker.bmp");
-        bottomPlayerPixmap = QPixmap(":/qrc/resources/images/black checker.bmp");
-    }
-    //
-
-    arrange(0, 3, topPlayerPixmap, _topPlayer, Checker::MoveDirection::Down);
-    arrange(5, boardEdgeSize, bottomPlayerPixmap, _bottomPlayer, Checker::MoveDirection::Up);
-}
-
-void Checkerboard::setConnections(Cell *_cell)
-{
-    connect(_cell, &Cell::cellSelected, this, &Checkerboard::onCellSelected);
-    connect(_cell, &Cell::cellDeselected, this, &Checkerboard::onCellUnselected);
-    connect(_cell, &Cell::checkerMoved, this, &Checkerboard::onCheckerMoved);
-    connect(_cell, &Cell::checkerJumped, this, &Checkerboard::onCheckerJumped);
-}
-
-void Checkerboard::setConnections(Checker *_checker)
-{
-    connect(_checker, &Checker::canMove, this, &Checkerboard::onCanMove);
-    connect(_checker, &Checker::readyMove, this, &Checkerboard::onReadyMove);
-    connect(_checker, &Checker::canJump, this, &Checkerboard::onCanJump);
-    connect(_checker, &Checker::readyJump, this, &Checkerboard::onReadyJump);
-    connect(this, &Checkerboard::checkJump, _checker, &Checker::onCheckJump);
-    connect(this, &Checkerboard::checkMove, _checker, &Checker::onCheckMove);
-}
-
-void Checkerboard::resetOpenedCells()
-{
-    for (auto cell : openedCells) {
-        cell->closeForMove();
-        cell->closeForJump();
-        cell->deactivate();
-        cell->setSelected(false);
-        cell->setBacklight(false);
-        cell->update();
-    }
-    openedCells.clear();
-}
-
-void Checkerboard::resetActivatedCells()
-{
-    for (auto cell : activatedCells) {
-        cell->deactivate();
-        cell->setSelected(false);
-        cell->setBacklight(false);
-        cell->update();
-    }
-    activatedCells.clear();
-}
-
-void Checkerboard::resetCheckersForDestruction()
-{
-    for (const auto& i : checkersForDestruction) {
-        auto cell = cells[i.desctinationIndex.first][i.desctinationIndex.second].get();
-        cell->closeForJump();
-    }
-    checkersForDestruction.clear();
-}
-
-void Checkerboard::changeLayoutAligment()
-{
-    if(height() < width())
-        mainLayout->setAlignment(Qt::AlignHCenter);
-    else
-        mainLayout->setAlignment(Qt::AlignVCenter);
-}
-
-void Checkerboard::onNextMove(Checker::Type _type)
-{
-    emit checkJump(_type, cells);
-
-    if(activatedCells.isEmpty())
-        emit checkMove(_type, cells);
-
-    if(activatedCells.isEmpty())
-        emit noMoves(_type);
-}
-
-void Checkerboard::onCanMove(const index_t &_index)
-{
-   auto cell = cells[_index.first][_index.second].get();   
-   cell->activate();
-   cell->setBacklight(true);
-   cell->update();
-   if(!activatedCells.contains(cell))
-       activatedCells.append(cell);
-}
-
-void Checkerboard::onCanJump(const index_t &_index)
-{
-    onCanMove(_index);
-}
-
-void Checkerboard::onReadyMove(const QVector<index_t> &_indeces)
-{
-    for (const auto& i : _indeces) {
-        auto cell = cells[i.first][i.second].get();
-        cell->activate();
-        cell->openForMove();
-        openedCells.append(cell);
-    }
-}
-
-void Checkerboard::onReadyJump(const QVector<Checker::JumpData> &_indeces)
-{
-    for(const auto& i : _indeces) {
-        auto cell = cells[i.desctinationIndex.first][i.desctinationIndex.second].get();
-        cell->activate();
-        cell->openForJump();
-        openedCells.append(cell);
-
-        checkersForDestruction.append(i);
-    }
-}
-
-void Checkerboard::onCellSelected(const index_t &_index)
-{
-    auto sender = cells[_index.first][_index.second].get();
-
-    for (auto cell : activatedCells) {        
-        if(cell != sender) {
-            cell->setSelected(false);
-            cell->setBacklight(false);
-        }
-        else {
-            resetOpenedCells();
-
-            sender->getChecker()->getJumpWays(cells);
-            if(openedCells.isEmpty())
-                sender->getChecker()->getMoveWays(cells);
-        }
-        cell->update();
-    }
-}
-
-void Checkerboard::onCellUnselected()
-{
-    for (auto cell : activatedCells) {
-        cell->setBacklight(true);
-        cell->update();
-    }
-    resetOpenedCells();
-    resetCheckersForDestruction();
-}
-
-void Checkerboard::onCheckerMoved(const index_t &_index)
-{
-    //qDebug() << "onCheckerMoved " << _index;
-    auto sender = cells[_index.first][_index.second].get();
-
-    for (auto cell : activatedCells) {
-        if(cell->isSelected()) {
-            cell->moveCheckerTo(sender);
-
-            resetActivatedCells();
-            resetOpenedCells();
-
-            emit endOfMove();
-            return;
-        }
-    }
-}
-
-void Checkerboard::onCheckerJumped(const index_t &_index)
-{
-    auto sender = cells[_index.first][_index.second].get();
-    Cell* destr = nullptr;
-
-    for (const auto& indices : checkersForDestruction) {
-        if(_index == indices.desctinationIndex) {
-            const auto& i = indices.destructionIndex;
-            destr = cells[i.first][i.second].get();
-        }
-    }
-
-    for (auto cell : activatedCells) {
-        if(cell->isSelected()) {
-            cell->moveCheckerTo(sender, destr);
-            destr->update();
-            destr = nullptr;
-
-            resetActivatedCells();
-            resetOpenedCells();
-            resetCheckersForDestruction();
-
-            const auto& type = sender->getChecker()->getType();
-            sender->getChecker()->onCheckJump(type, cells);
-            if(activatedCells.isEmpty())
-                emit endOfMove();
-            return;
-        }
-    }
-}
-
-int Checkerboard::getBoardSize() const
-{
-    return boardEdgeSize;
-}
+#include "checkerboard.hpp"
+#include "king.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+#include "startupreport.hpp"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QDebug>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QBitmap>
+
+#include <algorithm>
+
+namespace {
+const Metrics::Counter movesGenerated("checkers_moves_generated_total", "Legal moves produced by the board move generator.");
+const Metrics::Counter moveCacheLookups("checkers_move_cache_lookups_total", "Legal move cache lookups.");
+const Metrics::Counter moveCacheHits("checkers_move_cache_hits_total", "Legal move cache lookups answered from the cache.");
+
+// Decodes the checker bitmaps and applies their white-keyed masks off the GUI thread.
+class CheckerImageTask : public QRunnable
+{
+public:
+    explicit CheckerImageTask(Checkerboard *_board)
+        : board(_board)
+    {}
+
+    void run() override
+    {
+        const auto white = Checker::loadImage(":/qrc/resources/images/white checker.bmp");
+        const auto black = Checker::loadImage(":/qrc/resources/images/black checker.bmp");
+        const auto whiteKing = Checker::loadImage(":/qrc/resources/images/white king.bmp");
+        const auto blackKing = Checker::loadImage(":/qrc/resources/images/black king.bmp");
+        auto receiver = board;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [receiver, white, black, whiteKing, blackKing]() {
+            if(receiver)
+                receiver->setCheckerImages(white, black, whiteKing, blackKing);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QPointer<Checkerboard> board;
+};
+}
+
+Checkerboard::Checkerboard(const int _boardEdgeSize, QWidget *parent)
+    : Checkerboard(_boardEdgeSize, Variant::Classic, parent)
+{}
+
+Checkerboard::Checkerboard(const int _boardEdgeSize, const Variant _variant, QWidget *parent)
+    : QWidget(parent)
+    , mainLayout(new QGridLayout(this))
+    , oldSize(size())
+    , boardEdgeSize(_variant == Variant::Classic ? _boardEdgeSize : variantInfo(_variant).edge)
+    , animator(new MoveAnimator(this))
+    , animationsEnabled(true)
+    , bottomPlayer(Type::White)
+    , rules(_variant)
+    , turnStart(boardEdgeSize, _variant)
+    , pendingStep(0)
+{
+    initBoard();
+    setupLayout();
+    arrangeCheckers(Checker::Type::White, Checker::Type::Black);
+
+}
+
+void Checkerboard::resizeEvent(QResizeEvent *_event)
+{
+    QWidget::resizeEvent(_event);
+    animator->finish();
+    checkAspectRatio();
+}
+
+void Checkerboard::setAnimationsEnabled(bool _value)
+{
+    animationsEnabled = _value;
+    if(!animationsEnabled)
+        animator->finish();
+}
+
+void Checkerboard::animateMove(const QVector<Cell*> &_path, const QVector<MoveAnimator::Capture> &_captures)
+{
+    if(!animationsEnabled || !isVisible() || _path.size() < 2)
+        return;
+
+    auto destination = _path.last();
+    if(!destination->hasChecker())
+        return;
+
+    QVector<QRect> rects;
+    rects.reserve(_path.size());
+    for (auto cell : _path)
+        rects.append(cell->geometry());
+    animator->animate(rects, *destination->getChecker()->getImage(), _captures, destination);
+}
+
+MoveAnimator::Capture Checkerboard::captureOf(Cell *_cell) const
+{
+    MoveAnimator::Capture capture;
+    capture.rect = _cell->geometry();
+    if(_cell->hasChecker())
+        capture.sprite = *_cell->getChecker()->getImage();
+    return capture;
+}
+
+void Checkerboard::initBoard()
+{
+    auto color = QColor(Qt::black);
+
+    cells.reserve(boardEdgeSize);
+    for (int row = 0; row < boardEdgeSize; ++row) {
+        cells.push_back(boardEdge_t());
+        cells[row].reserve(boardEdgeSize / 2);
+
+        for (int col = 0; col < boardEdgeSize / 2; ++col) {
+           auto cell = std::make_unique<Cell>(row, col, color, this);
+           setConnections(cell.get());
+           cells[row].push_back(std::move(cell));
+        }
+    }
+}
+
+void Checkerboard::setupLayout()
+{
+    mainLayout->setSpacing(0);
+    mainLayout->setAlignment(Qt::AlignHCenter);
+
+    if(!cells.empty()) {
+        int rowNum = 0;
+        for (const auto& row : cells) {
+            int colNum = 0;
+            int rowIndex = rowNum++;
+            for (const auto& cell : row) {
+                int colIndex = colNum++ * 2;
+                if(rowIndex % 2 != 0) {
+                    mainLayout->addWidget(cell.get(), rowIndex, colIndex);
+                }
+                else {
+                    mainLayout->addWidget(cell.get(), rowIndex, colIndex + 1);
+                }
+            }
+        }
+    }
+    setLayout(mainLayout);
+}
+
+void Checkerboard::checkAspectRatio()
+{
+    if((size().width() < size().height() && oldSize.width() > oldSize.height()) ||
+        (size().width() > size().height() && oldSize.width() < oldSize.height()))
+    {
+        oldSize = size();
+        changeLayoutAligment();
+    }
+}
+
+void Checkerboard::arrangeCheckers(Type _bottomPlayer, Type _topPlayer)
+{
+    auto arrange = [&](int _fromRow, int _toRow, const QSharedPointer<QPixmap>& _checkerImage, Type _type, Checker::MoveDirection _direction) {
+        for(int row = _fromRow; row < _toRow; ++row) {
+            for (int col = 0; col < boardEdgeSize / 2; ++col) {
+                auto checker = std::make_unique<Checker>(row, col, _checkerImage, _type, _direction);
+                cells[row][col]->setChecker(std::move(checker));
+            }
+        }
+    };
+
+    // The pixmaps stay empty until CheckerImageTask delivers them; Cell draws a plain disc meanwhile.
+    if(!whiteImage) {
+        whiteImage = QSharedPointer<QPixmap>::create();
+        blackImage = QSharedPointer<QPixmap>::create();
+        whiteKingImage = QSharedPointer<QPixmap>::create();
+        blackKingImage = QSharedPointer<QPixmap>::create();
+        QThreadPool::globalInstance()->start(new CheckerImageTask(this));
+    }
+    bottomPlayer = _bottomPlayer;
+
+    const int rowsPerPlayer = boardEdgeSize / 2 - 1;
+    arrange(0, rowsPerPlayer, imageFor(_topPlayer), _topPlayer, Checker::MoveDirection::Down);
+    arrange(boardEdgeSize - rowsPerPlayer, boardEdgeSize, imageFor(_bottomPlayer), _bottomPlayer, Checker::MoveDirection::Up);
+}
+
+void Checkerboard::setCheckerImages(const QImage &_white, const QImage &_black, const QImage &_whiteKing, const QImage &_blackKing)
+{
+    TRACE_SPAN("Checkerboard::setCheckerImages");
+    *whiteImage = QPixmap::fromImage(_white);
+    *blackImage = QPixmap::fromImage(_black);
+    *whiteKingImage = QPixmap::fromImage(_whiteKing);
+    *blackKingImage = QPixmap::fromImage(_blackKing);
+    StartupReport::mark("checker images");
+
+    for (const auto& row : cells) {
+        for (const auto& cell : row) {
+            if(cell->hasChecker())
+                cell->update();
+        }
+    }
+    emit checkerImagesReady();
+}
+
+bool Checkerboard::hasCheckerImages() const
+{
+    return whiteImage && !whiteImage->isNull();
+}
+
+const QSharedPointer<QPixmap>& Checkerboard::imageFor(Type _type, bool _king) const
+{
+    if(_king)
+        return _type == Type::White ? whiteKingImage : blackKingImage;
+    return _type == Type::White ? whiteImage : blackImage;
+}
+
+void Checkerboard::setPosition(const Position &_position)
+{
+    TRACE_SPAN("Checkerboard::setPosition");
+    animator->finish();
+    resetOpenedCells();
+    resetActivatedCells();
+    resetCheckersForDestruction();
+    legalMoves = MoveCache::Entry();
+    pendingMoves.clear();
+
+    // Only squares whose content differs are rebuilt and repainted.
+    for (int square = 0; square < _position.squareCount(); ++square) {
+        auto cell = cells[_position.row(square)][_position.col(square)].get();
+        const auto& current = cell->getChecker();
+        const bool occupied = _position.occupied() & Position::bit(square);
+        const auto type = _position.pieces(Position::Side::White) & Position::bit(square) ? Type::White : Type::Black;
+        const bool king = _position.isKing(square);
+
+        if(!occupied && !current)
+            continue;
+        if(occupied && current && current->getType() == type && (dynamic_cast<King*>(current.get()) != nullptr) == king)
+            continue;
+
+        std::unique_ptr<Checker> checker;
+        if(occupied) {
+            const auto direction = type == bottomPlayer ? Checker::MoveDirection::Up : Checker::MoveDirection::Down;
+            if(king)
+                checker = std::make_unique<King>(cell->getIndex(), imageFor(type, true), type, direction, nullptr);
+            else
+                checker = std::make_unique<Checker>(cell->getIndex(), imageFor(type), type, direction);
+        }
+        cell->setChecker(std::move(checker));
+        cell->update();
+    }
+}
+
+void Checkerboard::setConnections(Cell *_cell)
+{
+    connect(_cell, &Cell::cellSelected, this, &Checkerboard::onCellSelected);
+    connect(_cell, &Cell::cellDeselected, this, &Checkerboard::onCellUnselected);
+    connect(_cell, &Cell::checkerMoved, this, &Checkerboard::onCheckerMoved);
+    connect(_cell, &Cell::checkerJumped, this, &Checkerboard::onCheckerJumped);
+}
+
+MoveCache::Entry Checkerboard::generateMoves(Type _type)
+{
+    TRACE_SPAN("Checkerboard::generateMoves");
+    MoveCache::Entry entry;
+
+    for (const auto& row : cells) {
+        for (const auto& cell : row) {
+            const auto& checker = cell->getChecker();
+            if(checker && checker->getType() == _type) {
+                const auto& jumps = checker->findJumpWays(cells);
+                if(!jumps.isEmpty())
+                    entry.jumps.insert(cell->getIndex(), jumps);
+            }
+        }
+    }
+
+    if(!entry.jumps.isEmpty()) {
+        for (const auto& jumps : entry.jumps)
+            movesGenerated.add(jumps.size());
+        return entry;
+    }
+
+    for (const auto& row : cells) {
+        for (const auto& cell : row) {
+            const auto& checker = cell->getChecker();
+            if(checker && checker->getType() == _type) {
+                const auto& moves = checker->findMoveWays(cells);
+                if(!moves.isEmpty()) {
+                    entry.moves.insert(cell->getIndex(), moves);
+                    movesGenerated.add(moves.size());
+                }
+            }
+        }
+    }
+    return entry;
+}
+
+MoveCache::Entry Checkerboard::generatorMoves(Type _type)
+{
+    TRACE_SPAN("Checkerboard::generatorMoves");
+    turnStart = toPosition(_type);
+    Position::MoveList moves;
+    turnStart.generateMoves(moves);
+    movesGenerated.add(moves.size());
+
+    pendingMoves.assign(moves.begin(), moves.end());
+    pendingStep = 0;
+    return pendingContinuations();
+}
+
+MoveCache::Entry Checkerboard::pendingContinuations() const
+{
+    MoveCache::Entry entry;
+    for (const auto& move : pendingMoves) {
+        if(move.length <= pendingStep)
+            continue;
+
+        const int from = pendingStep == 0 ? move.from : move.path[pendingStep - 1];
+        const int to = move.path[pendingStep];
+        if(move.isCapture()) {
+            auto& jumps = entry.jumps[indexOf(from)];
+            const auto target = indexOf(to);
+            const bool known = std::any_of(jumps.cbegin(), jumps.cend(), [&](const Checker::JumpData& _jump) {
+                return _jump.desctinationIndex == target;
+            });
+            if(!known)
+                jumps.append(Checker::JumpData(indexOf(turnStart.capturedBetween(from, to, move.captured)), target));
+        }
+        else {
+            auto& targets = entry.moves[indexOf(from)];
+            if(!targets.contains(indexOf(to)))
+                targets.append(indexOf(to));
+        }
+    }
+    return entry;
+}
+
+void Checkerboard::advancePendingMoves(const index_t &_origin, const index_t &_target)
+{
+    const int from = squareOf(_origin);
+    const int to = squareOf(_target);
+    std::vector<Position::Move> remaining;
+    for (const auto& move : pendingMoves) {
+        const int origin = pendingStep == 0 ? move.from : move.path[pendingStep - 1];
+        if(move.length > pendingStep && origin == from && move.path[pendingStep] == to)
+            remaining.push_back(move);
+    }
+    pendingMoves.swap(remaining);
+    ++pendingStep;
+}
+
+void Checkerboard::finishPendingMove(Cell *_destination)
+{
+    for (const auto& move : pendingMoves) {
+        if(move.length == pendingStep) {
+            crownIfPromoted(turnStart, move, _destination);
+            break;
+        }
+    }
+    pendingMoves.clear();
+}
+
+void Checkerboard::crownIfPromoted(const Position &_before, const Position::Move &_move, Cell *_destination)
+{
+    // Crowning follows Position::play(), which never crowns in Classic.
+    const auto& checker = _destination->getChecker();
+    if(!checker || dynamic_cast<King*>(checker.get()) || !_before.play(_move).isKing(_move.to))
+        return;
+
+    const auto type = checker->getType();
+    const auto direction = checker->getMoveDir();
+    _destination->setChecker(std::make_unique<King>(_destination->getIndex(), imageFor(type, true), type, direction, nullptr));
+    _destination->update();
+}
+
+Checker::index_t Checkerboard::indexOf(int _square) const
+{
+    return qMakePair(turnStart.row(_square), turnStart.col(_square));
+}
+
+int Checkerboard::squareOf(const index_t &_index) const
+{
+    return turnStart.square(_index.first, _index.second);
+}
+
+void Checkerboard::activateLegalMoves()
+{
+    for (auto it = legalMoves.jumps.cbegin(); it != legalMoves.jumps.cend(); ++it)
+        onCanJump(it.key());
+
+    if(legalMoves.jumps.isEmpty()) {
+        for (auto it = legalMoves.moves.cbegin(); it != legalMoves.moves.cend(); ++it)
+            onCanMove(it.key());
+    }
+}
+
+void Checkerboard::resetOpenedCells()
+{
+    for (auto cell : openedCells) {
+        cell->closeForMove();
+        cell->closeForJump();
+        cell->deactivate();
+        cell->setSelected(false);
+        cell->setBacklight(false);
+        cell->update();
+    }
+    openedCells.clear();
+}
+
+void Checkerboard::resetActivatedCells()
+{
+    for (auto cell : activatedCells) {
+        cell->deactivate();
+        cell->setSelected(false);
+        cell->setBacklight(false);
+        cell->update();
+    }
+    activatedCells.clear();
+}
+
+void Checkerboard::resetCheckersForDestruction()
+{
+    for (const auto& i : checkersForDestruction) {
+        auto cell = cells[i.desctinationIndex.first][i.desctinationIndex.second].get();
+        cell->closeForJump();
+    }
+    checkersForDestruction.clear();
+}
+
+void Checkerboard::changeLayoutAligment()
+{
+    if(height() < width())
+        mainLayout->setAlignment(Qt::AlignHCenter);
+    else
+        mainLayout->setAlignment(Qt::AlignVCenter);
+}
+
+void Checkerboard::onNextMove(Checker::Type _type)
+{
+    TRACE_SPAN("Checkerboard::onNextMove");
+    if(rules != Variant::Classic) {
+        legalMoves = generatorMoves(_type);
+    }
+    else {
+        const auto key = MoveCache::positionHash(cells, _type);
+        moveCacheLookups.add();
+        if(moveCache.contains(key))
+            moveCacheHits.add();
+        else
+            moveCache.insert(key, generateMoves(_type));
+        legalMoves = moveCache.value(key);
+    }
+
+    activateLegalMoves();
+
+    if(activatedCells.isEmpty())
+        emit noMoves(_type);
+}
+
+void Checkerboard::onCanMove(const index_t &_index)
+{
+   auto cell = cells[_index.first][_index.second].get();   
+   cell->activate();
+   cell->setBacklight(true);
+   cell->update();
+   if(!activatedCells.contains(cell))
+       activatedCells.append(cell);
+}
+
+void Checkerboard::onCanJump(const index_t &_index)
+{
+    onCanMove(_index);
+}
+
+void Checkerboard::onReadyMove(const QVector<index_t> &_indeces)
+{
+    for (const auto& i : _indeces) {
+        auto cell = cells[i.first][i.second].get();
+        cell->activate();
+        cell->openForMove();
+        openedCells.append(cell);
+    }
+}
+
+void Checkerboard::onReadyJump(const QVector<Checker::JumpData> &_indeces)
+{
+    for(const auto& i : _indeces) {
+        auto cell = cells[i.desctinationIndex.first][i.desctinationIndex.second].get();
+        cell->activate();
+        cell->openForJump();
+        openedCells.append(cell);
+
+        checkersForDestruction.append(i);
+    }
+}
+
+void Checkerboard::onCellSelected(const index_t &_index)
+{
+    TRACE_SPAN("Checkerboard::onCellSelected");
+    auto sender = cells[_index.first][_index.second].get();
+
+    for (auto cell : activatedCells) {        
+        if(cell != sender) {
+            cell->setSelected(false);
+            cell->setBacklight(false);
+        }
+        else {
+            resetOpenedCells();
+
+            const auto jumps = legalMoves.jumps.value(_index);
+            if(!jumps.isEmpty())
+                onReadyJump(jumps);
+            else
+                onReadyMove(legalMoves.moves.value(_index));
+        }
+        cell->update();
+    }
+}
+
+void Checkerboard::onCellUnselected()
+{
+    TRACE_SPAN("Checkerboard::onCellUnselected");
+    for (auto cell : activatedCells) {
+        cell->setBacklight(true);
+        cell->update();
+    }
+    resetOpenedCells();
+    resetCheckersForDestruction();
+}
+
+void Checkerboard::onCheckerMoved(const index_t &_index)
+{
+    TRACE_SPAN("Checkerboard::onCheckerMoved");
+    //qDebug() << "onCheckerMoved " << _index;
+    auto sender = cells[_index.first][_index.second].get();
+
+    for (auto cell : activatedCells) {
+        if(cell->isSelected()) {
+            cell->moveCheckerTo(sender);
+            legalMoves = MoveCache::Entry();
+            if(rules != Variant::Classic) {
+                advancePendingMoves(cell->getIndex(), _index);
+                finishPendingMove(sender);
+            }
+
+            resetActivatedCells();
+            resetOpenedCells();
+            animateMove({ cell, sender }, {});
+
+            emit endOfMove();
+            return;
+        }
+    }
+}
+
+void Checkerboard::onCheckerJumped(const index_t &_index)
+{
+    TRACE_SPAN("Checkerboard::onCheckerJumped");
+    auto sender = cells[_index.first][_index.second].get();
+    Cell* destr = nullptr;
+
+    for (const auto& indices : checkersForDestruction) {
+        if(_index == indices.desctinationIndex) {
+            const auto& i = indices.destructionIndex;
+            destr = cells[i.first][i.second].get();
+        }
+    }
+
+    for (auto cell : activatedCells) {
+        if(cell->isSelected()) {
+            const auto capture = captureOf(destr);
+            cell->moveCheckerTo(sender, destr);
+            destr->update();
+            destr = nullptr;
+
+            resetActivatedCells();
+            resetOpenedCells();
+            resetCheckersForDestruction();
+            animateMove({ cell, sender }, { capture });
+
+            if(rules != Variant::Classic) {
+                advancePendingMoves(cell->getIndex(), _index);
+                legalMoves = pendingContinuations();
+                activateLegalMoves();
+                if(activatedCells.isEmpty()) {
+                    finishPendingMove(sender);
+                    emit endOfMove();
+                }
+                return;
+            }
+
+            const auto& checker = sender->getChecker();
+            const auto key = MoveCache::continuationHash(MoveCache::positionHash(cells, checker->getType()), _index);
+            moveCacheLookups.add();
+            if(moveCache.contains(key)) {
+                moveCacheHits.add();
+            }
+            else {
+                MoveCache::Entry entry;
+                const auto& jumps = checker->findJumpWays(cells);
+                if(!jumps.isEmpty()) {
+                    entry.jumps.insert(_index, jumps);
+                    movesGenerated.add(jumps.size());
+                }
+                moveCache.insert(key, entry);
+            }
+            legalMoves = moveCache.value(key);
+
+            activateLegalMoves();
+            if(activatedCells.isEmpty())
+                emit endOfMove();
+            return;
+        }
+    }
+}
+
+Position Checkerboard::toPosition(Type _sideToMove) const
+{
+    Position position(boardEdgeSize, rules);
+    position.setSideToMove(_sideToMove == Type::White ? Position::Side::White : Position::Side::Black);
+
+    for (const auto& row : cells) {
+        for (const auto& cell : row) {
+            const auto& checker = cell->getChecker();
+            if(checker) {
+                const auto& index = cell->getIndex();
+                const auto side = checker->getType() == Type::White ? Position::Side::White : Position::Side::Black;
+                position.put(position.square(index.first, index.second), side, dynamic_cast<King*>(checker.get()) != nullptr);
+            }
+        }
+    }
+    return position;
+}
+
+void Checkerboard::playMove(const Position::Move &_move)
+{
+    TRACE_SPAN("Checkerboard::playMove");
+
+    resetOpenedCells();
+    resetActivatedCells();
+    resetCheckersForDestruction();
+    legalMoves = MoveCache::Entry();
+    pendingMoves.clear();
+
+    const Position geometry(boardEdgeSize);
+    const auto& mover = cells[geometry.row(_move.from)][geometry.col(_move.from)]->getChecker();
+    const auto before = toPosition(mover ? mover->getType() : Type::White);
+    auto cellAt = [&](int _square) {
+        return cells[geometry.row(_square)][geometry.col(_square)].get();
+    };
+
+    QVector<Cell*> path { cellAt(_move.from) };
+    QVector<MoveAnimator::Capture> captures;
+
+    int from = _move.from;
+    for (int i = 0; i < _move.length; ++i) {
+        const int to = _move.path[i];
+        auto source = cellAt(from);
+        auto destination = cellAt(to);
+        const auto victim = _move.isCapture() ? geometry.capturedBetween(from, to, _move.captured) : -1;
+        path.append(destination);
+
+        if(victim >= 0) {
+            captures.append(captureOf(cellAt(victim)));
+            source->moveCheckerTo(destination, cellAt(victim));
+            cellAt(victim)->update();
+        }
+        else {
+            source->moveCheckerTo(destination);
+        }
+        source->update();
+        destination->update();
+        from = to;
+    }
+    crownIfPromoted(before, _move, cellAt(_move.to));
+    animateMove(path, captures);
+
+    emit endOfMove();
+}
+
+int Checkerboard::getBoardSize() const
+{
+    return boardEdgeSize;
+}
+
+Variant Checkerboard::variant() const
+{
+    return rules;
+}
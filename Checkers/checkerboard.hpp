@@ -1,71 +1,109 @@
-#pragma once
-
-#include "cell.hpp"
-#include "checker.hpp"
-
-#include <QWidget>
-#include <QVector>
-#include <QList>
-#include <QGridLayout>
-
-class Checkerboard : public QWidget
-{
-    Q_OBJECT
-    using boardEdge_t = Checker::boardEdge_t;
-    using Type = Checker::Type;
-    using board_t = Checker::board_t;
-    using index_t = Checker::index_t;
-
-public:
-    explicit Checkerboard(const int _boardEdgeSize = 8, QWidget *_parent = nullptr);
-
-    int getBoardSize() const;
-    void arrangeCheckers(Type _firstPlayer, Type _secondPlayer);
-
-public slots:
-    void onNextMove(Type _type);
-
-signals:
-    void noMoves(const Type &_type);
-    void endOfMove();
-    void aspectRatioChanged();
-    void checkJump(const Type &_type, const board_t &_cells);
-    void checkMove(const Type &_type, const board_t &_cells);
-
-protected:
-    void resizeEvent(QResizeEvent *_event) override;
-
-private slots:
-    void changeLayoutAligment();
-
-    void onCanMove(const index_t &_index);
-    void onCanJump(const index_t &_index);
-    void onReadyMove(const QVector<index_t> &_indeces);
-    void onReadyJump(const QVector<Checker::JumpData> &_indeces);
-
-    void onCheckerMoved(const index_t &_index);
-    void onCheckerJumped(const index_t &_index);
-
-    void onCellSelected(const index_t &_index);
-    void onCellUnselected();
-
-private:
-    void initBoard();
-    void setupLayout();
-    void checkAspectRatio();
-    void setConnections(Cell *_cell);
-    void setConnections(Checker *_checker);
-    void resetOpenedCells();
-    void resetActivatedCells();
-    void resetCheckersForDestruction();
-
-private:
-    QGridLayout *mainLayout;
-    board_t cells;
-    QList<Cell*> activatedCells;
-    QList<Cell*> openedCells;
-    QList<Checker::JumpData> checkersForDestruction;
-    QSize oldSize;
-    const int boardEdgeSize;
-};
-
+#pragma once
+
+#include "cell.hpp"
+#include "checker.hpp"
+#include "movecache.hpp"
+#include "position.hpp"
+#include "moveanimator.hpp"
+
+#include <QWidget>
+#include <QVector>
+#include <QList>
+#include <QGridLayout>
+
+class Checkerboard : public QWidget
+{
+    Q_OBJECT
+    using boardEdge_t = Checker::boardEdge_t;
+    using Type = Checker::Type;
+    using board_t = Checker::board_t;
+    using index_t = Checker::index_t;
+
+public:
+    explicit Checkerboard(const int _boardEdgeSize = 8, QWidget *_parent = nullptr);
+    Checkerboard(const int _boardEdgeSize, const Variant _variant, QWidget *_parent = nullptr);
+
+    int getBoardSize() const;
+    Variant variant() const;
+    void arrangeCheckers(Type _firstPlayer, Type _secondPlayer);
+    Position toPosition(Type _sideToMove) const;
+    // Brings the board to _position by rebuilding only the cells whose content differs.
+    void setPosition(const Position &_position);
+    // Installs the decoded checker sprites into the pixmaps shared by every Checker.
+    void setCheckerImages(const QImage &_white, const QImage &_black, const QImage &_whiteKing, const QImage &_blackKing);
+    bool hasCheckerImages() const;
+    void setAnimationsEnabled(bool _value);
+
+public slots:
+    void onNextMove(Type _type);
+    void playMove(const Position::Move &_move);
+
+signals:
+    void noMoves(const Type &_type);
+    void endOfMove();
+    void aspectRatioChanged();
+    void checkerImagesReady();
+
+protected:
+    void resizeEvent(QResizeEvent *_event) override;
+
+private slots:
+    void changeLayoutAligment();
+
+    void onCanMove(const index_t &_index);
+    void onCanJump(const index_t &_index);
+    void onReadyMove(const QVector<index_t> &_indeces);
+    void onReadyJump(const QVector<Checker::JumpData> &_indeces);
+
+    void onCheckerMoved(const index_t &_index);
+    void onCheckerJumped(const index_t &_index);
+
+    void onCellSelected(const index_t &_index);
+    void onCellUnselected();
+
+private:
+    void initBoard();
+    void setupLayout();
+    void checkAspectRatio();
+    void setConnections(Cell *_cell);
+    const QSharedPointer<QPixmap>& imageFor(Type _type, bool _king = false) const;
+    MoveCache::Entry generateMoves(Type _type);
+    MoveCache::Entry generatorMoves(Type _type);
+    MoveCache::Entry pendingContinuations() const;
+    void advancePendingMoves(const index_t &_origin, const index_t &_target);
+    void finishPendingMove(Cell *_destination);
+    void crownIfPromoted(const Position &_before, const Position::Move &_move, Cell *_destination);
+    index_t indexOf(int _square) const;
+    int squareOf(const index_t &_index) const;
+    void activateLegalMoves();
+    void animateMove(const QVector<Cell*> &_path, const QVector<MoveAnimator::Capture> &_captures);
+    MoveAnimator::Capture captureOf(Cell *_cell) const;
+    void resetOpenedCells();
+    void resetActivatedCells();
+    void resetCheckersForDestruction();
+
+private:
+    QGridLayout *mainLayout;
+    board_t cells;
+    QList<Cell*> activatedCells;
+    QList<Cell*> openedCells;
+    QList<Checker::JumpData> checkersForDestruction;
+    MoveCache moveCache;
+    MoveCache::Entry legalMoves;
+    QSize oldSize;
+    const int boardEdgeSize;
+    MoveAnimator *animator;
+    bool animationsEnabled;
+    QSharedPointer<QPixmap> whiteImage;
+    QSharedPointer<QPixmap> blackImage;
+    QSharedPointer<QPixmap> whiteKingImage;
+    QSharedPointer<QPixmap> blackKingImage;
+    Type bottomPlayer;
+    Variant rules;
+    // Variants other than Classic take their legal moves from the Position generator; a move in
+    // progress narrows pendingMoves one step at a time.
+    Position turnStart;
+    std::vector<Position::Move> pendingMoves;
+    int pendingStep;
+};
+
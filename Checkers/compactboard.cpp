@@ -0,0 +1,289 @@
+#include "compactboard.hpp"
+#include "trace.hpp"
+#include "startupreport.hpp"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QTimer>
+
+namespace {
+
+enum Sprite { WhiteMan, BlackMan, WhiteKing, BlackKing, SpriteCount };
+
+// One sheet of piece sprites at the current square size, shared by every board. The decoded
+// source bitmaps are dropped once the sheet is built and decoded again only on a resize.
+struct SpriteSheet
+{
+    QPixmap sheet;
+    int tileSize = 0;
+};
+
+SpriteSheet& spriteSheet()
+{
+    static SpriteSheet instance;
+    return instance;
+}
+
+QImage decode(const QString &_fileName, const int _size)
+{
+    return Checker::loadImage(_fileName).scaled(_size, _size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+void buildSpriteSheet(const int _tileSize)
+{
+    TRACE_SPAN("CompactBoard::buildSpriteSheet");
+    auto& sprites = spriteSheet();
+    if(sprites.tileSize == _tileSize)
+        return;
+
+    QImage sheet(_tileSize * SpriteCount, _tileSize, QImage::Format_ARGB32_Premultiplied);
+    sheet.fill(Qt::transparent);
+    QPainter painter(&sheet);
+    painter.drawImage(WhiteMan * _tileSize, 0, decode(":/qrc/resources/images/white checker.bmp", _tileSize));
+    painter.drawImage(BlackMan * _tileSize, 0, decode(":/qrc/resources/images/black checker.bmp", _tileSize));
+    painter.drawImage(WhiteKing * _tileSize, 0, decode(":/qrc/resources/images/white king.bmp", _tileSize));
+    painter.drawImage(BlackKing * _tileSize, 0, decode(":/qrc/resources/images/black king.bmp", _tileSize));
+    painter.end();
+
+    sprites.sheet = QPixmap::fromImage(sheet);
+    sprites.tileSize = _tileSize;
+}
+
+}
+
+CompactBoard::CompactBoard(const int _boardEdgeSize, QWidget *_parent)
+    : CompactBoard(_boardEdgeSize, Variant::Classic, _parent)
+{}
+
+CompactBoard::CompactBoard(const int _boardEdgeSize, const Variant _variant, QWidget *_parent)
+    : QWidget(_parent)
+    , position(_variant == Variant::Classic ? Position::initial(_boardEdgeSize) : Position::initial(_variant))
+    , step(0)
+    , selected(-1)
+{
+    setMinimumSize(32 * _boardEdgeSize, 32 * _boardEdgeSize);
+    setFocusPolicy(Qt::ClickFocus);
+}
+
+int CompactBoard::getBoardSize() const
+{
+    return position.edge();
+}
+
+Variant CompactBoard::variant() const
+{
+    return position.variant();
+}
+
+Position CompactBoard::toPosition(Type _sideToMove) const
+{
+    auto result = position;
+    result.setSideToMove(_sideToMove == Type::White ? Position::Side::White : Position::Side::Black);
+    return result;
+}
+
+void CompactBoard::setPosition(const Position &_position)
+{
+    position = _position;
+    candidates.clear();
+    resetSelection();
+    update();
+}
+
+bool CompactBoard::hasCheckerImages() const
+{
+    return spriteSheet().tileSize > 0;
+}
+
+QSize CompactBoard::sizeHint() const
+{
+    return QSize(64, 64) * position.edge();
+}
+
+void CompactBoard::onNextMove(Type _type)
+{
+    TRACE_SPAN("CompactBoard::onNextMove");
+    position.setSideToMove(_type == Type::White ? Position::Side::White : Position::Side::Black);
+
+    Position::MoveList moves;
+    position.generateMoves(moves);
+    candidates.assign(moves.begin(), moves.end());
+    resetSelection();
+    update();
+
+    if(candidates.empty())
+        emit noMoves(_type);
+}
+
+void CompactBoard::playMove(const Position::Move &_move)
+{
+    TRACE_SPAN("CompactBoard::playMove");
+    position = position.play(_move);
+    candidates.clear();
+    resetSelection();
+    update();
+    emit endOfMove();
+}
+
+void CompactBoard::resetSelection()
+{
+    step = 0;
+    selected = -1;
+}
+
+QRect CompactBoard::boardRect() const
+{
+    const auto side = qMin(width(), height()) / position.edge() * position.edge();
+    return QRect((width() - side) / 2, (height() - side) / 2, side, side);
+}
+
+QRect CompactBoard::squareRect(int _square) const
+{
+    const auto area = boardRect();
+    const auto squareSize = area.width() / position.edge();
+    const auto row = position.row(_square);
+    const auto layoutCol = position.col(_square) * 2 + (row % 2 != 0 ? 0 : 1);
+    return QRect(area.left() + layoutCol * squareSize, area.top() + row * squareSize, squareSize, squareSize);
+}
+
+int CompactBoard::squareAt(const QPoint &_point) const
+{
+    const auto area = boardRect();
+    if(!area.contains(_point))
+        return -1;
+
+    const auto squareSize = area.width() / position.edge();
+    const auto row = (_point.y() - area.top()) / squareSize;
+    const auto layoutCol = (_point.x() - area.left()) / squareSize;
+    if((layoutCol % 2 != 0) != (row % 2 == 0))
+        return -1;
+    return position.square(row, layoutCol / 2);
+}
+
+void CompactBoard::loadSprites()
+{
+    const auto firstLoad = !hasCheckerImages();
+    buildSpriteSheet(boardRect().width() / position.edge());
+    if(firstLoad) {
+        StartupReport::mark("checker images");
+        emit checkerImagesReady();
+    }
+    update();
+}
+
+void CompactBoard::paintEvent(QPaintEvent *_event)
+{
+    TRACE_SPAN("CompactBoard::paintEvent");
+    QWidget::paintEvent(_event);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+
+    const auto area = boardRect();
+    const auto tileSize = area.width() / position.edge();
+    painter.fillRect(area, Qt::white);
+
+    // The sprite sheet is built after the frame that needs it, like the bitmaps of Checkerboard.
+    const auto& sprites = spriteSheet();
+    if(sprites.tileSize != tileSize && tileSize > 0)
+        QTimer::singleShot(0, this, &CompactBoard::loadSprites);
+
+    // The piece being moved is drawn on the last square entered; the squares it may enter next are lit.
+    auto shown = position;
+    quint64 targets = 0;
+    quint64 sources = 0;
+    for (const auto& move : candidates) {
+        if(selected < 0 || move.from == selected) {
+            if(selected < 0)
+                sources |= Position::bit(move.from);
+            else if(step < move.length)
+                targets |= Position::bit(move.path[step]);
+        }
+    }
+    if(selected >= 0 && step > 0) {
+        const auto king = position.isKing(selected);
+        shown.clear(selected);
+        shown.put(candidates.front().path[step - 1], position.sideToMove(), king);
+    }
+    const bool capture = !candidates.empty() && candidates.front().isCapture();
+
+    for (int square = 0; square < position.squareCount(); ++square) {
+        const auto rect = squareRect(square);
+        const auto bit = Position::bit(square);
+
+        QRadialGradient grad(rect.center(), rect.width() / 2);
+        const QColor dark(Qt::black);
+        if(targets & bit) {
+            const QColor main = capture ? Qt::red : Qt::green;
+            for (auto stop : { 0.15, 0.55, 0.9 })
+                grad.setColorAt(stop, main);
+            for (auto stop : { 0.3, 0.7, 1.0 })
+                grad.setColorAt(stop, dark);
+            painter.setBrush(grad);
+        }
+        else if((sources & bit) || square == selected) {
+            grad.setColorAt(0.9, Qt::green);
+            grad.setColorAt(1, dark);
+            painter.setBrush(grad);
+        }
+        else {
+            painter.setBrush(dark);
+        }
+        painter.drawRect(rect);
+
+        if(!(shown.occupied() & bit))
+            continue;
+        const bool white = shown.pieces(Position::Side::White) & bit;
+        if(sprites.tileSize == tileSize) {
+            const auto sprite = white ? (shown.isKing(square) ? WhiteKing : WhiteMan) : (shown.isKing(square) ? BlackKing : BlackMan);
+            painter.drawPixmap(rect.topLeft(), sprites.sheet, QRect(sprite * tileSize, 0, tileSize, tileSize));
+        }
+        else {
+            // Stand-in until the sprite sheet has been built for this size.
+            painter.setBrush(white ? Qt::lightGray : Qt::darkGray);
+            painter.drawEllipse(rect.adjusted(rect.width() / 8, rect.height() / 8, -rect.width() / 8, -rect.height() / 8));
+        }
+    }
+}
+
+void CompactBoard::mousePressEvent(QMouseEvent *_event)
+{
+    TRACE_SPAN("CompactBoard::mousePressEvent");
+    QWidget::mousePressEvent(_event);
+
+    const auto square = squareAt(_event->pos());
+    if(square < 0 || candidates.empty())
+        return;
+
+    // Before the first step any piece with a legal move can be picked up, or picked again.
+    if(step == 0) {
+        for (const auto& move : candidates) {
+            if(move.from == square) {
+                selected = square;
+                update();
+                return;
+            }
+        }
+    }
+    if(selected < 0)
+        return;
+
+    std::vector<Position::Move> remaining;
+    for (const auto& move : candidates) {
+        if(move.from == selected && step < move.length && move.path[step] == square)
+            remaining.push_back(move);
+    }
+    if(remaining.empty())
+        return;
+
+    ++step;
+    for (const auto& move : remaining) {
+        if(move.length == step) {
+            playMove(move);
+            return;
+        }
+    }
+    candidates.swap(remaining);
+    update();
+}
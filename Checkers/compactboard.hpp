@@ -0,0 +1,56 @@
+#pragma once
+
+#include "checker.hpp"
+#include "position.hpp"
+
+#include <QWidget>
+
+#include <vector>
+
+// Single-widget board for the low-memory build. The game state is one Position and the pieces
+// are painted from one sprite sheet shared by every board, instead of a Cell widget per square
+// and a Checker object per piece. It offers the part of the Checkerboard interface MainWindow uses.
+class CompactBoard : public QWidget
+{
+    Q_OBJECT
+    using Type = Checker::Type;
+
+public:
+    explicit CompactBoard(const int _boardEdgeSize = 8, QWidget *_parent = nullptr);
+    CompactBoard(const int _boardEdgeSize, const Variant _variant, QWidget *_parent = nullptr);
+
+    int getBoardSize() const;
+    Variant variant() const;
+    Position toPosition(Type _sideToMove) const;
+    void setPosition(const Position &_position);
+    bool hasCheckerImages() const;
+
+    QSize sizeHint() const override;
+
+public slots:
+    void onNextMove(Type _type);
+    void playMove(const Position::Move &_move);
+
+signals:
+    void noMoves(const Type &_type);
+    void endOfMove();
+    void checkerImagesReady();
+
+protected:
+    void paintEvent(QPaintEvent *_event) override;
+    void mousePressEvent(QMouseEvent *_event) override;
+
+private:
+    QRect boardRect() const;
+    QRect squareRect(int _square) const;
+    int squareAt(const QPoint &_point) const;
+    void loadSprites();
+    void resetSelection();
+
+private:
+    Position position;
+    // Legal moves that still match the squares clicked so far; step of them have been entered.
+    std::vector<Position::Move> candidates;
+    int step;
+    int selected;
+};
@@ -0,0 +1,314 @@
+#include "engine.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef CHECKERS_SEARCH_PROFILE
+#define SEARCH_PROFILE(statement) statement
+#else
+#define SEARCH_PROFILE(statement)
+#endif
+
+namespace {
+
+const Metrics::Counter searchNodesTotal("checkers_search_nodes_total", "Nodes visited by the engine search.");
+const Metrics::Counter ttProbesTotal("checkers_tt_probes_total", "Transposition table probes.");
+const Metrics::Counter ttHitsTotal("checkers_tt_hits_total", "Transposition table probes that matched the position key.");
+
+const int manValue = 100;
+const int kingValue = 300;
+
+int popCount(quint64 _mask)
+{
+    int count = 0;
+    for (; _mask; _mask &= _mask - 1)
+        ++count;
+    return count;
+}
+
+int scoreToTable(int _score, int _ply)
+{
+    if(_score > Engine::winScore - Engine::maxDepth * 2)
+        return _score + _ply;
+    if(_score < -Engine::winScore + Engine::maxDepth * 2)
+        return _score - _ply;
+    return _score;
+}
+
+int scoreFromTable(int _score, int _ply)
+{
+    if(_score > Engine::winScore - Engine::maxDepth * 2)
+        return _score - _ply;
+    if(_score < -Engine::winScore + Engine::maxDepth * 2)
+        return _score + _ply;
+    return _score;
+}
+
+}
+
+Engine::Engine(const int _hashMegabytes)
+    : stopRequested(false)
+    , deadlineNs(noDeadline)
+    , cancelled(nullptr)
+    , nodeLimit(0)
+    , searchNodes(0)
+{
+    resizeHash(_hashMegabytes);
+}
+
+qint64 Engine::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Engine::stop()
+{
+    stopRequested.store(true, std::memory_order_relaxed);
+}
+
+void Engine::setDeadline(const qint64 _deadlineNs)
+{
+    deadlineNs.store(_deadlineNs, std::memory_order_relaxed);
+}
+
+void Engine::resizeHash(const int _megabytes)
+{
+    const auto bytes = static_cast<size_t>(std::max(_megabytes, 1)) * 1024 * 1024;
+    size_t entries = 1;
+    while(entries * 2 * sizeof(TTEntry) <= bytes)
+        entries *= 2;
+    table.assign(entries, TTEntry());
+}
+
+void Engine::clearHash()
+{
+    std::fill(table.begin(), table.end(), TTEntry());
+}
+
+Engine::TTEntry *Engine::probe(const quint64 _key)
+{
+    return &table[_key & (table.size() - 1)];
+}
+
+int Engine::evaluate(const Position &_position)
+{
+    int score = 0;
+    for (auto player : { Position::Side::White, Position::Side::Black }) {
+        int sideScore = 0;
+        const auto pieces = _position.pieces(player);
+        const auto kings = pieces & _position.kingMask();
+        sideScore += popCount(pieces & ~kings) * manValue + popCount(kings) * kingValue;
+
+        // Reward men for advancing towards the promotion row.
+        for (auto mask = pieces & ~kings; mask; mask &= mask - 1) {
+            int square = 0;
+            while(!((mask >> square) & 1))
+                ++square;
+            const int row = _position.row(square);
+            sideScore += 2 * (player == Position::Side::White ? _position.edge() - 1 - row : row);
+        }
+        score += player == Position::Side::White ? sideScore : -sideScore;
+    }
+    return _position.sideToMove() == Position::Side::White ? score : -score;
+}
+
+bool Engine::shouldStop()
+{
+    if(stopRequested.load(std::memory_order_relaxed))
+        return true;
+    if(cancelled && cancelled->load(std::memory_order_relaxed))
+        return true;
+    if(nodeLimit && searchNodes >= nodeLimit)
+        return true;
+    if((searchNodes & 1023) == 0) {
+        const auto deadline = deadlineNs.load(std::memory_order_relaxed);
+        if(deadline != noDeadline && now() >= deadline)
+            stopRequested.store(true, std::memory_order_relaxed);
+    }
+    return stopRequested.load(std::memory_order_relaxed);
+}
+
+void Engine::orderMoves(const Position::MoveList &_moves, const int _ttMove, std::array<quint8, Position::maxMoves> &_order) const
+{
+    for (int i = 0; i < _moves.size(); ++i)
+        _order[i] = static_cast<quint8>(i);
+
+    // Hash move first, then longer captures.
+    std::stable_sort(_order.begin(), _order.begin() + _moves.size(), [&](quint8 _a, quint8 _b) {
+        if((_a == _ttMove) != (_b == _ttMove))
+            return _a == _ttMove;
+        return popCount(_moves[_a].captured) > popCount(_moves[_b].captured);
+    });
+}
+
+int Engine::negamax(const Position &_position, int _depth, int _alpha, int _beta, int _ply)
+{
+    ++searchNodes;
+    ++stats.nodes;
+    SEARCH_PROFILE(profiler.enterNode(_ply));
+
+    Position::MoveList moves;
+    SEARCH_PROFILE(const auto generateStart = now());
+    _position.generateMoves(moves);
+    SEARCH_PROFILE(profiler.addMoveGenerationTime(now() - generateStart));
+    SEARCH_PROFILE(profiler.generated(_ply, moves.size()));
+    if(moves.empty())
+        return -winScore + _ply;
+    if(_ply > 0 && path.isDraw())
+        return 0;
+
+    // Captures are forced, so they never end a line at the horizon.
+    if((_depth <= 0 && !moves[0].isCapture()) || _ply >= maxDepth * 2) {
+#ifdef CHECKERS_SEARCH_PROFILE
+        const auto evaluateStart = now();
+        const auto score = evaluate(_position);
+        profiler.addEvaluationTime(now() - evaluateStart);
+        return score;
+#else
+        return evaluate(_position);
+#endif
+    }
+
+    const auto key = path.currentHash();
+    auto entry = probe(key);
+    ++stats.ttProbes;
+    SEARCH_PROFILE(profiler.probe(entry->key == key && entry->bound != Bound::None ? SearchProfiler::Probe::Hit
+        : (entry->bound != Bound::None ? SearchProfiler::Probe::Collision : SearchProfiler::Probe::Miss)));
+    int ttMove = -1;
+    if(entry->key == key && entry->bound != Bound::None) {
+        ++stats.ttHits;
+        ttMove = entry->moveIndex < moves.size() ? entry->moveIndex : -1;
+        if(entry->depth >= _depth && _ply > 0) {
+            const auto score = scoreFromTable(entry->score, _ply);
+            if(entry->bound == Bound::Exact
+                    || (entry->bound == Bound::Lower && score >= _beta)
+                    || (entry->bound == Bound::Upper && score <= _alpha))
+                return score;
+        }
+    }
+
+    std::array<quint8, Position::maxMoves> order;
+    orderMoves(moves, ttMove, order);
+
+    const int originalAlpha = _alpha;
+    int best = -infinity;
+    int bestIndex = order[0];
+    for (int i = 0; i < moves.size(); ++i) {
+        const auto index = order[i];
+        const auto child = _position.play(moves[index]);
+        path.push(_position, child);
+        const auto score = -negamax(child, _depth - 1, -_beta, -_alpha, _ply + 1);
+        path.pop();
+        SEARCH_PROFILE(profiler.searchedChild(_ply));
+        if(shouldStop())
+            return best == -infinity ? score : best;
+
+        if(score > best) {
+            best = score;
+            bestIndex = index;
+        }
+        if(score > _alpha)
+            _alpha = score;
+        if(_alpha >= _beta) {
+            SEARCH_PROFILE(profiler.cutoff(_ply, i));
+            break;
+        }
+    }
+    SEARCH_PROFILE(profiler.sample(_ply, _depth, originalAlpha, _beta, best, key));
+
+    if(entry->key != key || _depth >= entry->depth) {
+        entry->key = key;
+        entry->score = static_cast<qint16>(scoreToTable(best, _ply));
+        entry->depth = static_cast<qint8>(std::max(_depth, 0));
+        entry->moveIndex = static_cast<quint8>(bestIndex);
+        entry->bound = best <= originalAlpha ? Bound::Upper : (best >= _beta ? Bound::Lower : Bound::Exact);
+    }
+    return best;
+}
+
+std::vector<Position::Move> Engine::extractPv(const Position &_root, int _depth) const
+{
+    std::vector<Position::Move> pv;
+    auto position = _root;
+    for (int ply = 0; ply < _depth; ++ply) {
+        const auto key = position.hash();
+        const auto& entry = table[key & (table.size() - 1)];
+        if(entry.key != key || entry.bound == Bound::None)
+            break;
+
+        Position::MoveList moves;
+        position.generateMoves(moves);
+        if(entry.moveIndex >= moves.size())
+            break;
+        pv.push_back(moves[entry.moveIndex]);
+        position = position.play(moves[entry.moveIndex]);
+    }
+    return pv;
+}
+
+Engine::Result Engine::search(const Position &_root, const Limits &_limits, const InfoCallback &_info,
+                              const GameHistory *_history)
+{
+    stopRequested.store(false, std::memory_order_relaxed);
+    if(_limits.timeMs > 0)
+        setDeadline(now() + _limits.timeMs * 1000000);
+    cancelled = _limits.cancelled;
+    nodeLimit = _limits.nodes;
+    searchNodes = 0;
+    SEARCH_PROFILE(profiler.reset());
+    SEARCH_PROFILE(const auto searchStart = now());
+
+    if(_history && _history->currentHash() == _root.hash())
+        path.reset(*_history);
+    else
+        path.reset(_root);
+
+    Result result;
+    const auto before = stats;
+    // Every exit clears the deadline, publishes the search's counts once and, in profiling
+    // builds, records the search time.
+    auto finish = [&] {
+        result.nodes = searchNodes;
+        searchNodesTotal.add(stats.nodes - before.nodes);
+        ttProbesTotal.add(stats.ttProbes - before.ttProbes);
+        ttHitsTotal.add(stats.ttHits - before.ttHits);
+        setDeadline(noDeadline);
+        SEARCH_PROFILE(profiledNs = now() - searchStart);
+        return result;
+    };
+
+    Position::MoveList moves;
+    _root.generateMoves(moves);
+    if(moves.empty())
+        return finish();
+
+    result.hasMove = true;
+    result.move = moves[0];
+    if(moves.size() == 1 && _limits.timeMs > 0) {
+        result.pv.push_back(moves[0]);
+        return finish();
+    }
+
+    for (int depth = 1; depth <= std::min(_limits.depth, static_cast<int>(maxDepth)); ++depth) {
+        const auto score = negamax(_root, depth, -infinity, infinity, 0);
+        if(shouldStop() && depth > 1)
+            break;
+
+        auto pv = extractPv(_root, depth);
+        if(!pv.empty()) {
+            result.move = pv.front();
+            result.pv = std::move(pv);
+        }
+        result.score = score;
+        result.depth = depth;
+        result.nodes = searchNodes;
+        if(_info)
+            _info(result);
+
+        if(std::abs(score) > winScore - maxDepth * 2)
+            break;
+    }
+    return finish();
+}
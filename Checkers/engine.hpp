@@ -0,0 +1,108 @@
+#pragma once
+
+#include "gamehistory.hpp"
+#ifdef CHECKERS_SEARCH_PROFILE
+#include "searchprofiler.hpp"
+#endif
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+class Engine
+{
+public:
+    static constexpr int infinity = 32000;
+    static constexpr int winScore = 30000;
+    static constexpr int maxDepth = 64;
+    static constexpr qint64 noDeadline = -1;
+#ifdef CHECKERS_LOW_MEMORY
+    static constexpr int defaultHashMegabytes = 1;
+#else
+    static constexpr int defaultHashMegabytes = 16;
+#endif
+
+    struct Limits
+    {
+        int depth = maxDepth;
+        quint64 nodes = 0;
+        qint64 timeMs = 0;
+        // Stops the search like stop(), but search() never clears it, so the caller can set it
+        // before the search has begun.
+        const std::atomic<bool> *cancelled = nullptr;
+    };
+
+    struct Result
+    {
+        bool hasMove = false;
+        Position::Move move;
+        int score = 0;
+        int depth = 0;
+        quint64 nodes = 0;
+        std::vector<Position::Move> pv;
+    };
+
+    struct Statistics
+    {
+        quint64 nodes = 0;
+        quint64 ttProbes = 0;
+        quint64 ttHits = 0;
+    };
+
+    using InfoCallback = std::function<void(const Result&)>;
+
+    explicit Engine(const int _hashMegabytes = defaultHashMegabytes);
+
+    // _history, when given, ends with _root; repetitions of its earlier positions score as draws.
+    Result search(const Position &_root, const Limits &_limits, const InfoCallback &_info = InfoCallback(),
+                  const GameHistory *_history = nullptr);
+
+    void stop();
+    // Replaces the time limit of the running search; noDeadline searches until stopped.
+    void setDeadline(const qint64 _deadlineNs);
+    static qint64 now();
+
+    void resizeHash(const int _megabytes);
+    void clearHash();
+    const Statistics& statistics() const { return stats; }
+
+    static int evaluate(const Position &_position);
+
+#ifdef CHECKERS_SEARCH_PROFILE
+    // Covers the most recent search() call only.
+    const SearchProfiler& profile() const { return profiler; }
+    qint64 profiledSearchNs() const { return profiledNs; }
+#endif
+
+private:
+    enum class Bound : quint8 { None, Exact, Lower, Upper };
+
+    struct TTEntry
+    {
+        quint64 key = 0;
+        qint16 score = 0;
+        qint8 depth = -1;
+        Bound bound = Bound::None;
+        quint8 moveIndex = 0xFF;
+    };
+
+    int negamax(const Position &_position, int _depth, int _alpha, int _beta, int _ply);
+    bool shouldStop();
+    void orderMoves(const Position::MoveList &_moves, const int _ttMove, std::array<quint8, Position::maxMoves> &_order) const;
+    std::vector<Position::Move> extractPv(const Position &_root, int _depth) const;
+    TTEntry* probe(const quint64 _key);
+
+private:
+    std::vector<TTEntry> table;
+    SearchPath path;
+    Statistics stats;
+    std::atomic<bool> stopRequested;
+    std::atomic<qint64> deadlineNs;
+    const std::atomic<bool> *cancelled;
+    quint64 nodeLimit;
+    quint64 searchNodes;
+#ifdef CHECKERS_SEARCH_PROFILE
+    SearchProfiler profiler;
+    qint64 profiledNs = 0;
+#endif
+};
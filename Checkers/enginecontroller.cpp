@@ -0,0 +1,194 @@
+#include "enginecontroller.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+
+#ifdef CHECKERS_SEARCH_PROFILE
+#include <fstream>
+#endif
+
+namespace {
+
+const Metrics::Counter ponderHits("checkers_ponder_hits_total", "Opponent replies that matched the pondered move.");
+const Metrics::Histogram searchDuration("checkers_search_seconds", "Wall time of one engine search.");
+
+}
+
+EngineWorker::EngineWorker(Engine *_engine, std::atomic<quint64> *_latestRequest, QObject *_parent)
+    : QObject(_parent)
+    , engine(_engine)
+    , latestRequest(_latestRequest)
+{}
+
+void EngineWorker::search(quint64 _requestId, const GameHistory &_history, const Engine::Limits &_limits)
+{
+    // Requests superseded while they were queued are dropped without searching.
+    if(_requestId < latestRequest->load())
+        return;
+
+    TRACE_SPAN("EngineWorker::search");
+    const auto begin = Engine::now();
+    const auto& position = _history.current();
+    const auto result = engine->search(position, _limits, Engine::InfoCallback(), &_history);
+    searchDuration.observe(Engine::now() - begin);
+
+#ifdef CHECKERS_SEARCH_PROFILE
+    // Profiling builds append one report per search to the file named by CHECKERS_PROFILE_REPORT.
+    const auto reportFile = qgetenv("CHECKERS_PROFILE_REPORT");
+    if(!reportFile.isEmpty()) {
+        std::ofstream out(reportFile.constData(), std::ios::app);
+        out << "position " << position.toFen() << " depth " << result.depth << '\n';
+        engine->profile().report(out, engine->profiledSearchNs());
+        if(qEnvironmentVariableIsSet("CHECKERS_PROFILE_TREE"))
+            engine->profile().dumpTree(out);
+        out << '\n';
+    }
+#endif
+
+    emit finished(_requestId, position, result);
+}
+
+EngineController::EngineController(QObject *_parent)
+    : QObject(_parent)
+    , worker(new EngineWorker(&engine, &latestRequest))
+    , latestRequest(0)
+    , moveTimeMs(1000)
+    , ponderEnabled(true)
+    , moveRequest(0)
+    , ponderRequest(0)
+    , ponderKey(0)
+    , ponderFinished(false)
+{
+    qRegisterMetaType<Position>();
+    qRegisterMetaType<Position::Move>();
+    qRegisterMetaType<Engine::Limits>();
+    qRegisterMetaType<Engine::Result>();
+    qRegisterMetaType<GameHistory>();
+
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(this, &EngineController::searchRequested, worker, &EngineWorker::search, Qt::QueuedConnection);
+    connect(worker, &EngineWorker::finished, this, &EngineController::onSearchFinished, Qt::QueuedConnection);
+    thread.setObjectName("EngineThread");
+    thread.start();
+}
+
+EngineController::~EngineController()
+{
+    cancel();
+    thread.quit();
+    thread.wait();
+}
+
+void EngineController::setMoveTime(const qint64 _ms)
+{
+    moveTimeMs = _ms;
+}
+
+void EngineController::setHashSize(const int _megabytes)
+{
+    cancel();
+    auto target = &engine;
+    QMetaObject::invokeMethod(worker, [target, _megabytes]() { target->resizeHash(_megabytes); }, Qt::QueuedConnection);
+}
+
+void EngineController::setPondering(const bool _enabled)
+{
+    ponderEnabled = _enabled;
+    if(!ponderEnabled)
+        stopPondering();
+}
+
+quint64 EngineController::startSearch(const GameHistory &_history, const Engine::Limits &_limits)
+{
+    const auto requestId = ++latestRequest;
+    emit searchRequested(requestId, _history, _limits);
+    return requestId;
+}
+
+void EngineController::requestMove(const Position &_position, const GameHistory &_history)
+{
+    if(ponderRequest && _position.hash() == ponderKey) {
+        ponderHits.add();
+        const auto hit = ponderRequest;
+        ponderRequest = 0;
+        moveHistory = ponderHistory;
+
+        if(ponderFinished) {
+            deliver(moveHistory, ponderResult);
+            return;
+        }
+        // The running ponder search becomes the real search; it only needs a deadline now.
+        moveRequest = hit;
+        engine.setDeadline(Engine::now() + moveTimeMs * 1000000);
+        return;
+    }
+
+    stopPondering();
+
+    moveHistory = _history;
+    if(moveHistory.currentHash() != _position.hash())
+        moveHistory.reset(_position);
+
+    Engine::Limits limits;
+    limits.timeMs = moveTimeMs;
+    moveRequest = startSearch(moveHistory, limits);
+}
+
+void EngineController::cancel()
+{
+    moveRequest = 0;
+    ponderRequest = 0;
+    ++latestRequest;
+    engine.stop();
+}
+
+void EngineController::stopPondering()
+{
+    if(!ponderRequest)
+        return;
+    ponderRequest = 0;
+    ++latestRequest;
+    engine.stop();
+}
+
+void EngineController::startPondering(const GameHistory &_afterMove, const Engine::Result &_result)
+{
+    if(!ponderEnabled || _result.pv.size() < 2)
+        return;
+
+    ponderHistory = _afterMove;
+    ponderHistory.play(_result.pv[1]);
+    if(ponderHistory.outcome() != GameHistory::Outcome::Ongoing)
+        return;
+
+    ponderKey = ponderHistory.currentHash();
+    ponderFinished = false;
+    engine.setDeadline(Engine::noDeadline);
+    ponderRequest = startSearch(ponderHistory, Engine::Limits());
+}
+
+void EngineController::deliver(const GameHistory &_history, const Engine::Result &_result)
+{
+    moveRequest = 0;
+    if(!_result.hasMove)
+        return;
+
+    emit analysisReady(_history.current(), _result);
+    emit moveReady(_result.move);
+
+    auto afterMove = _history;
+    afterMove.play(_result.move);
+    startPondering(afterMove, _result);
+}
+
+void EngineController::onSearchFinished(quint64 _requestId, const Position &_position, const Engine::Result &_result)
+{
+    Q_UNUSED(_position);
+    if(_requestId == ponderRequest) {
+        ponderFinished = true;
+        ponderResult = _result;
+        return;
+    }
+    if(_requestId == moveRequest)
+        deliver(moveHistory, _result);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "engine.hpp"
+
+#include <QObject>
+#include <QThread>
+
+#include <atomic>
+
+Q_DECLARE_METATYPE(Position)
+Q_DECLARE_METATYPE(Position::Move)
+Q_DECLARE_METATYPE(Engine::Limits)
+Q_DECLARE_METATYPE(Engine::Result)
+Q_DECLARE_METATYPE(GameHistory)
+
+class EngineWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EngineWorker(Engine *_engine, std::atomic<quint64> *_latestRequest, QObject *_parent = nullptr);
+
+public slots:
+    void search(quint64 _requestId, const GameHistory &_history, const Engine::Limits &_limits);
+
+signals:
+    void finished(quint64 _requestId, const Position &_position, const Engine::Result &_result);
+
+private:
+    Engine *engine;
+    std::atomic<quint64> *latestRequest;
+};
+
+class EngineController : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EngineController(QObject *_parent = nullptr);
+    ~EngineController() override;
+
+    void setMoveTime(const qint64 _ms);
+    void setPondering(const bool _enabled);
+    // Takes effect between searches, on the engine thread.
+    void setHashSize(const int _megabytes);
+
+    // _history ends with _position; the search scores repetitions of the game so far as draws.
+    void requestMove(const Position &_position, const GameHistory &_history);
+    void cancel();
+
+signals:
+    void moveReady(const Position::Move &_move);
+    // Emitted with the full result for every search whose move is delivered, before moveReady.
+    void analysisReady(const Position &_position, const Engine::Result &_result);
+    void searchRequested(quint64 _requestId, const GameHistory &_history, const Engine::Limits &_limits);
+
+private slots:
+    void onSearchFinished(quint64 _requestId, const Position &_position, const Engine::Result &_result);
+
+private:
+    quint64 startSearch(const GameHistory &_history, const Engine::Limits &_limits);
+    void startPondering(const GameHistory &_afterMove, const Engine::Result &_result);
+    void stopPondering();
+    void deliver(const GameHistory &_history, const Engine::Result &_result);
+
+private:
+    Engine engine;
+    QThread thread;
+    EngineWorker *worker;
+    std::atomic<quint64> latestRequest;
+    qint64 moveTimeMs;
+    bool ponderEnabled;
+
+    quint64 moveRequest;
+    GameHistory moveHistory;
+    quint64 ponderRequest;
+    quint64 ponderKey;
+    GameHistory ponderHistory;
+    bool ponderFinished;
+    Engine::Result ponderResult;
+};
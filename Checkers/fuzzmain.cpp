@@ -0,0 +1,368 @@
+#include "checkerboard.hpp"
+#include "movecache.hpp"
+#include "position.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Moves = std::vector<Position::Move>;
+
+Checker::Type toType(const Position::Side _side)
+{
+    return _side == Position::Side::White ? Checker::Type::White : Checker::Type::Black;
+}
+
+bool lessMove(const Position::Move &_a, const Position::Move &_b)
+{
+    if(_a.from != _b.from)
+        return _a.from < _b.from;
+    if(_a.captured != _b.captured)
+        return _a.captured < _b.captured;
+    return std::lexicographical_compare(_a.path.begin(), _a.path.begin() + _a.length,
+                                        _b.path.begin(), _b.path.begin() + _b.length);
+}
+
+// Generates complete moves with the widget rules: Checker::findJumpWays()/findMoveWays() on a
+// board of Cells, following multi-jumps step by step the way Checkerboard::onCheckerJumped() does.
+// Only men are supported; Classic never crowns.
+class ReferenceBoard
+{
+public:
+    explicit ReferenceBoard(const int _edge)
+        : edge(_edge)
+    {
+        cells.reserve(edge);
+        for (int row = 0; row < edge; ++row) {
+            cells.push_back(Checker::boardEdge_t());
+            for (int col = 0; col < edge / 2; ++col)
+                cells[row].push_back(std::make_unique<Cell>(row, col));
+        }
+    }
+
+    // Like Checkerboard::setPosition(), only squares whose content differs get a new Checker.
+    void load(const Position &_position)
+    {
+        for (int square = 0; square < _position.squareCount(); ++square) {
+            auto& cell = cells[_position.row(square)][_position.col(square)];
+            const auto& current = cell->getChecker();
+            const bool occupied = _position.occupied() & Position::bit(square);
+            const bool white = _position.pieces(Position::Side::White) & Position::bit(square);
+            const auto type = white ? Checker::Type::White : Checker::Type::Black;
+            if(!occupied && !current)
+                continue;
+            if(occupied && current && current->getType() == type)
+                continue;
+
+            std::unique_ptr<Checker> checker;
+            if(occupied)
+                checker = std::make_unique<Checker>(_position.row(square), _position.col(square), image, type,
+                                                    white ? Checker::MoveDirection::Up : Checker::MoveDirection::Down);
+            cell->setChecker(std::move(checker));
+        }
+    }
+
+    quint64 hash(const Position &_position)
+    {
+        load(_position);
+        return MoveCache::positionHash(cells, toType(_position.sideToMove()));
+    }
+
+    Moves generate(const Position &_position)
+    {
+        Moves moves;
+        load(_position);
+        for (int square = 0; square < _position.squareCount(); ++square) {
+            if(!(_position.pieces(_position.sideToMove()) & Position::bit(square)))
+                continue;
+            Position::Move move;
+            move.from = static_cast<quint8>(square);
+            extendJump(_position, square, move, moves);
+        }
+        if(!moves.empty())
+            return moves;
+
+        load(_position);
+        for (int square = 0; square < _position.squareCount(); ++square) {
+            if(!(_position.pieces(_position.sideToMove()) & Position::bit(square)))
+                continue;
+            const auto targets = checkerAt(_position, square)->findMoveWays(cells);
+            for (const auto& target : targets) {
+                Position::Move move;
+                move.from = static_cast<quint8>(square);
+                move.to = static_cast<quint8>(_position.square(target.first, target.second));
+                move.length = 1;
+                move.path[0] = move.to;
+                moves.push_back(move);
+            }
+        }
+        return moves;
+    }
+
+private:
+    Checker* checkerAt(const Position &_geometry, const int _square) const
+    {
+        return cells[_geometry.row(_square)][_geometry.col(_square)]->getChecker().get();
+    }
+
+    // _scratch already has earlier captures removed and the jumping man on _square.
+    void extendJump(const Position &_scratch, const int _square, Position::Move &_move, Moves &_moves)
+    {
+        load(_scratch);
+        const auto jumps = checkerAt(_scratch, _square)->findJumpWays(cells);
+        if(jumps.isEmpty() || _move.length == Position::maxPath) {
+            if(_move.length > 0) {
+                _move.to = static_cast<quint8>(_square);
+                _moves.push_back(_move);
+            }
+            return;
+        }
+
+        for (const auto& jump : jumps) {
+            const int victim = _scratch.square(jump.destructionIndex.first, jump.destructionIndex.second);
+            const int landing = _scratch.square(jump.desctinationIndex.first, jump.desctinationIndex.second);
+
+            auto next = _scratch;
+            next.clear(_square);
+            next.clear(victim);
+            next.put(landing, _scratch.sideToMove(), false);
+
+            _move.path[_move.length++] = static_cast<quint8>(landing);
+            const auto captured = _move.captured;
+            _move.captured |= Position::bit(victim);
+            extendJump(next, landing, _move, _moves);
+            _move.captured = captured;
+            --_move.length;
+        }
+    }
+
+private:
+    const int edge;
+    Checker::board_t cells;
+    const QSharedPointer<QPixmap> image;
+};
+
+struct Harness
+{
+    explicit Harness(const int _edge)
+        : reference(_edge)
+        , edge(_edge)
+        , board(_edge)
+    {
+        board.setAnimationsEnabled(false);
+    }
+
+    // Returns an empty string when both generators agree, otherwise a description of the divergence.
+    QString check(const Position &_position)
+    {
+        ++positions;
+
+        Position::MoveList list;
+        _position.generateMoves(list);
+        Moves actual(list.begin(), list.end());
+        auto expected = reference.generate(_position);
+        std::sort(actual.begin(), actual.end(), lessMove);
+        std::sort(expected.begin(), expected.end(), lessMove);
+        if(actual != expected)
+            return "move lists differ\n  reference: " + describe(_position, expected) + "\n  position:  " + describe(_position, actual);
+
+        if(reference.hash(_position) != _position.hash())
+            return "MoveCache::positionHash() differs from Position::hash()";
+
+        Position parsed;
+        if(!Position::fromFen(_position.toFen(), parsed, edge) || parsed.toFen() != _position.toFen() || parsed.hash() != _position.hash())
+            return "FEN round trip failed";
+
+        for (const auto& move : actual) {
+            Position::Move parsedMove;
+            if(!_position.parseMove(_position.moveToString(move), parsedMove) || parsedMove != move)
+                return QString("move text round trip failed for %1").arg(QString::fromStdString(_position.moveToString(move)));
+
+            const auto next = _position.play(move);
+            if(next.hash() == _position.hash() || (next.occupied() & ~_position.occupied() & ~Position::bit(move.to)))
+                return QString("play() corrupted the position for %1").arg(QString::fromStdString(_position.moveToString(move)));
+        }
+        return QString();
+    }
+
+    static QString describe(const Position &_position, const Moves &_moves)
+    {
+        QStringList texts;
+        for (const auto& move : _moves)
+            texts << QString::fromStdString(_position.moveToString(move));
+        return texts.join(' ');
+    }
+
+    ReferenceBoard reference;
+    const int edge;
+    // Reused by every playout, so a game does not build a board of Cell widgets.
+    Checkerboard board;
+    quint64 positions = 0;
+};
+
+// Plays one game on a live Checkerboard next to a Position, checking every position on the
+// way and that Checkerboard::playMove() lands on Position::play().
+template<typename Chooser>
+QString playout(Harness &_harness, const int _maxPlies, Chooser _choose, QString &_fen)
+{
+    auto& board = _harness.board;
+    auto position = Position::initial(_harness.edge);
+    board.setPosition(position);
+
+    for (int ply = 0; ply < _maxPlies; ++ply) {
+        _fen = QString::fromStdString(position.toFen());
+        const auto error = _harness.check(position);
+        if(!error.isEmpty())
+            return error;
+
+        if(board.toPosition(toType(position.sideToMove())).hash() != position.hash())
+            return "Checkerboard and Position diverged";
+
+        Position::MoveList moves;
+        position.generateMoves(moves);
+        if(moves.empty())
+            break;
+
+        const auto& move = moves[_choose(moves.size())];
+        board.playMove(move);
+        position = position.play(move);
+    }
+    return QString();
+}
+
+Position randomPosition(const int _edge, std::mt19937_64 &_generator)
+{
+    Position position(_edge);
+    std::uniform_int_distribution<int> content(0, 5);
+    for (int square = 0; square < position.squareCount(); ++square) {
+        const int row = position.row(square);
+        const auto value = content(_generator);
+        if(value == 0 && row != 0)
+            position.put(square, Position::Side::White, false);
+        else if(value == 1 && row != _edge - 1)
+            position.put(square, Position::Side::Black, false);
+    }
+    position.setSideToMove(_generator() & 1 ? Position::Side::White : Position::Side::Black);
+    return position;
+}
+
+}
+
+#ifdef CHECKERS_LIBFUZZER
+
+// Each input byte picks the next move of a game from the initial position; the first byte picks the board.
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    new QApplication(*argc, *argv);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if(size == 0)
+        return 0;
+
+    static Harness small(8);
+    static Harness large(10);
+    auto& harness = data[0] & 1 ? large : small;
+
+    size_t next = 1;
+    QString fen;
+    const auto error = playout(harness, static_cast<int>(size), [&](int _count) {
+        return next < size ? data[next++] % _count : 0;
+    }, fen);
+    if(!error.isEmpty()) {
+        QTextStream(stderr) << "divergence at " << fen << ": " << error << '\n';
+        std::abort();
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("CheckersFuzz");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Cross-checks the Position move generator against the Checker/Checkerboard rules.");
+    parser.addHelpOption();
+    QCommandLineOption boardSizesOption("board-sizes", "Comma separated board edge sizes.", "sizes", "8,10");
+    QCommandLineOption secondsOption("seconds", "Run time per board size; 0 for no time limit.", "seconds", "10");
+    QCommandLineOption gamesOption("games", "Games per board size; 0 for no game limit.", "count", "0");
+    QCommandLineOption seedOption("seed", "Random seed; 0 picks one from the clock.", "seed", "0");
+    QCommandLineOption pliesOption("max-plies", "Maximum plies per random playout.", "plies", "200");
+    parser.addOptions({ boardSizesOption, secondsOption, gamesOption, seedOption, pliesOption });
+    parser.process(app);
+
+    auto seed = parser.value(seedOption).toULongLong();
+    if(!seed)
+        seed = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
+    const auto seconds = parser.value(secondsOption).toDouble();
+    const auto maxPlies = parser.value(pliesOption).toInt();
+    const auto gameLimit = parser.value(gamesOption).toULongLong();
+
+    QTextStream out(stdout);
+    if(seconds <= 0 && !gameLimit) {
+        out << "--seconds 0 needs a --games limit\n";
+        return 2;
+    }
+    out << "seed " << seed << '\n';
+
+    for (const auto& sizeText : parser.value(boardSizesOption).split(',', QString::SkipEmptyParts)) {
+        const auto edge = sizeText.toInt();
+        if(edge != 8 && edge != 10) {
+            out << "skipping unsupported board size " << sizeText << '\n';
+            continue;
+        }
+
+        std::mt19937_64 generator(seed + edge);
+        Harness harness(edge);
+        QElapsedTimer timer;
+        timer.start();
+        quint64 games = 0;
+
+        // Alternate whole games, which exercise Checkerboard::playMove(), with random placements,
+        // which reach capture patterns real games rarely produce.
+        while((seconds <= 0 || timer.elapsed() < seconds * 1000) && (!gameLimit || games < gameLimit)) {
+            QString fen;
+            auto error = playout(harness, maxPlies, [&](int _count) {
+                return static_cast<int>(generator() % _count);
+            }, fen);
+            ++games;
+
+            for (int i = 0; error.isEmpty() && i < 64; ++i) {
+                const auto position = randomPosition(edge, generator);
+                fen = QString::fromStdString(position.toFen());
+                error = harness.check(position);
+            }
+
+            if(!error.isEmpty()) {
+                out << "board " << edge << ": divergence at " << fen << "\n" << error << '\n';
+                return 1;
+            }
+        }
+
+        const auto elapsed = qMax(timer.elapsed(), qint64(1)) / 1000.0;
+        out << "board " << edge << ": " << harness.positions << " positions, " << games << " games, "
+            << qRound64(harness.positions / elapsed) << " positions/s, "
+            << qRound64(harness.positions * 60 / elapsed) << " positions/min\n";
+    }
+    return 0;
+}
+
+#endif
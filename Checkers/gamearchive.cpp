@@ -0,0 +1,199 @@
+#include "gamearchive.hpp"
+
+#include <cctype>
+
+namespace {
+
+bool isResult(const std::string &_token)
+{
+    return _token == "1-0" || _token == "0-1" || _token == "1/2-1/2" || _token == "*"
+            || _token == "2-0" || _token == "0-2" || _token == "1-1";
+}
+
+bool isMoveNumber(const std::string &_token)
+{
+    size_t digits = 0;
+    while(digits < _token.size() && std::isdigit(static_cast<unsigned char>(_token[digits])))
+        ++digits;
+    return digits > 0 && digits < _token.size() && _token.find_first_not_of('.', digits) == std::string::npos;
+}
+
+class Parser
+{
+public:
+    Parser(const std::string &_text, const int _edge, const Variant _variant)
+        : text(_text)
+        , edge(_edge)
+        , variant(_variant)
+        , offset(0)
+    {}
+
+    bool run(std::vector<GameRecord> &_games, std::string &_error)
+    {
+        startGame();
+        while(skipSpace()) {
+            const char c = text[offset];
+            if(c == '[') {
+                if(hasMoves)
+                    finishGame(_games);
+                if(!readTag(_error))
+                    return false;
+            }
+            else if(c == '{') {
+                const auto end = text.find('}', offset);
+                offset = end == std::string::npos ? text.size() : end + 1;
+            }
+            else if(c == ';') {
+                const auto end = text.find('\n', offset);
+                offset = end == std::string::npos ? text.size() : end + 1;
+            }
+            else if(!readToken(_games, _error)) {
+                return false;
+            }
+        }
+        if(hasMoves || !current.tags.empty())
+            finishGame(_games);
+        return true;
+    }
+
+private:
+    bool skipSpace()
+    {
+        while(offset < text.size() && std::isspace(static_cast<unsigned char>(text[offset])))
+            ++offset;
+        return offset < text.size();
+    }
+
+    void startGame()
+    {
+        current = GameRecord();
+        current.start = variant == Variant::Classic ? Position::initial(edge) : Position::initial(variant);
+        position = current.start;
+        hasMoves = false;
+    }
+
+    void finishGame(std::vector<GameRecord> &_games)
+    {
+        _games.push_back(std::move(current));
+        startGame();
+    }
+
+    bool readTag(std::string &_error)
+    {
+        const auto end = text.find(']', offset);
+        if(end == std::string::npos)
+            return fail(_error, "unterminated tag");
+
+        const auto body = text.substr(offset + 1, end - offset - 1);
+        offset = end + 1;
+        const auto open = body.find('"');
+        const auto close = body.rfind('"');
+        if(open == std::string::npos || close == open)
+            return fail(_error, "malformed tag [" + body + "]");
+
+        auto name = body.substr(0, open);
+        while(!name.empty() && std::isspace(static_cast<unsigned char>(name.back())))
+            name.pop_back();
+        const auto value = body.substr(open + 1, close - open - 1);
+        current.tags.emplace_back(name, value);
+
+        if(name == "FEN") {
+            if(!Position::fromFen(value, current.start, edge, variant))
+                return fail(_error, "invalid FEN \"" + value + "\"");
+            position = current.start;
+        }
+        return true;
+    }
+
+    bool readToken(std::vector<GameRecord> &_games, std::string &_error)
+    {
+        auto end = offset;
+        while(end < text.size() && !std::isspace(static_cast<unsigned char>(text[end])) && text[end] != '{' && text[end] != '[')
+            ++end;
+        auto token = text.substr(offset, end - offset);
+        offset = end;
+
+        if(isResult(token)) {
+            current.result = token;
+            finishGame(_games);
+            return true;
+        }
+        if(isMoveNumber(token))
+            return true;
+
+        // Move numbers may be glued to the move ("12.22-17"), annotations to its end ("22-17!?").
+        const auto dot = token.rfind('.');
+        if(dot != std::string::npos)
+            token.erase(0, dot + 1);
+        while(!token.empty() && (token.back() == '!' || token.back() == '?'))
+            token.pop_back();
+        if(token.empty())
+            return true;
+
+        Position::Move move;
+        if(!position.parseMove(token, move))
+            return fail(_error, "illegal move \"" + token + "\" at ply " + std::to_string(current.moves.size() + 1));
+        current.moves.push_back(move);
+        position = position.play(move);
+        hasMoves = true;
+        return true;
+    }
+
+    bool fail(std::string &_error, const std::string &_message)
+    {
+        _error = _message;
+        return false;
+    }
+
+private:
+    const std::string &text;
+    const int edge;
+    const Variant variant;
+    size_t offset;
+    GameRecord current;
+    Position position;
+    bool hasMoves;
+};
+
+}
+
+std::string GameRecord::tag(const std::string &_name) const
+{
+    for (const auto& tag : tags) {
+        if(tag.first == _name)
+            return tag.second;
+    }
+    return std::string();
+}
+
+bool GameArchive::parse(const std::string &_text, std::vector<GameRecord> &_games, std::string *_error, const int _edge, const Variant _variant)
+{
+    std::string error;
+    Parser parser(_text, _edge, _variant);
+    const auto before = _games.size();
+    if(parser.run(_games, error))
+        return true;
+
+    if(_error)
+        *_error = "game " + std::to_string(_games.size() - before + 1) + ": " + error;
+    return false;
+}
+
+std::string GameArchive::write(const GameRecord &_game)
+{
+    std::string text;
+    for (const auto& tag : _game.tags)
+        text += "[" + tag.first + " \"" + tag.second + "\"]\n";
+    if(!_game.tags.empty())
+        text += '\n';
+
+    auto position = _game.start;
+    for (size_t ply = 0; ply < _game.moves.size(); ++ply) {
+        if(ply % 2 == 0)
+            text += std::to_string(ply / 2 + 1) + ". ";
+        text += position.moveToString(_game.moves[ply]) + ' ';
+        position = position.play(_game.moves[ply]);
+    }
+    text += _game.result + '\n';
+    return text;
+}
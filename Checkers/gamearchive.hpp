@@ -0,0 +1,27 @@
+#pragma once
+
+#include "position.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct GameRecord
+{
+    std::vector<std::pair<std::string, std::string>> tags;
+    Position start;
+    std::vector<Position::Move> moves;
+    std::string result = "*";
+
+    std::string tag(const std::string &_name) const;
+};
+
+// Reads PDN-like game archives: [Tag "value"] headers, an optional [FEN "..."] setup,
+// numbered move text in this project's square numbering, {comments} and a result token.
+class GameArchive
+{
+public:
+    static bool parse(const std::string &_text, std::vector<GameRecord> &_games, std::string *_error = nullptr,
+                      const int _edge = 8, const Variant _variant = Variant::Classic);
+    static std::string write(const GameRecord &_game);
+};
@@ -0,0 +1,123 @@
+#include "gamehistory.hpp"
+
+GameHistory::GameHistory(const Position &_start)
+{
+    reset(_start);
+}
+
+void GameHistory::reset(const Position &_start)
+{
+    position = _start;
+    hashes.assign(1, _start.hash());
+    counts.clear();
+    counts[_start.hash()] = 1;
+    plyCount = 0;
+    quietLimit = variantInfo(_start.variant()).quietMoveLimit * 2;
+}
+
+void GameHistory::setQuietMoveLimit(const int _moves)
+{
+    quietLimit = _moves * 2;
+}
+
+void GameHistory::push(const Position &_position)
+{
+    if(isIrreversible(position, _position)) {
+        hashes.clear();
+        counts.clear();
+    }
+    hashes.push_back(_position.hash());
+    ++counts[_position.hash()];
+    position = _position;
+    ++plyCount;
+}
+
+GameHistory::Outcome GameHistory::outcome() const
+{
+    if(!position.hasMoves())
+        return position.sideToMove() == Position::Side::White ? Outcome::BlackWins : Outcome::WhiteWins;
+    if(repetitions() >= 3)
+        return Outcome::Repetition;
+    if(quietPlies() >= quietLimit)
+        return Outcome::MoveLimit;
+    return Outcome::Ongoing;
+}
+
+bool GameHistory::isIrreversible(const Position &_before, const Position &_after)
+{
+    // Captures and man moves, promotions included, can never be undone.
+    const auto men = [](const Position &_position) { return _position.occupied() & ~_position.kingMask(); };
+    const auto opponent = Position::opponent(_before.sideToMove());
+    return men(_before) != men(_after) || _before.pieces(opponent) != _after.pieces(opponent);
+}
+
+const char *GameHistory::outcomeName(const Outcome _outcome)
+{
+    switch (_outcome) {
+    case Outcome::Ongoing: return "ongoing";
+    case Outcome::WhiteWins: return "white";
+    case Outcome::BlackWins: return "black";
+    case Outcome::Repetition: return "repetition";
+    case Outcome::MoveLimit: return "move-limit";
+    }
+    return "unknown";
+}
+
+SearchPath::SearchPath()
+{
+    reset(Position::initial());
+}
+
+void SearchPath::reset(const Position &_root)
+{
+    entries.clear();
+    filter.fill(0);
+    quietPlyLimit = variantInfo(_root.variant()).quietMoveLimit * 2;
+    append(_root.hash(), 0);
+}
+
+void SearchPath::reset(const GameHistory &_history)
+{
+    entries.clear();
+    filter.fill(0);
+    quietPlyLimit = _history.quietPlyLimit();
+    const auto& hashes = _history.reversibleHashes();
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+        append(hashes[i], static_cast<int>(i));
+}
+
+void SearchPath::push(const Position &_parent, const Position &_child)
+{
+    append(_child.hash(), GameHistory::isIrreversible(_parent, _child) ? 0 : quietPlies() + 1);
+}
+
+void SearchPath::pop()
+{
+    if(entries.size() < 2)
+        return;
+    --filter[slotOf(currentHash())];
+    entries.pop_back();
+}
+
+void SearchPath::append(const quint64 _hash, const int _quiet)
+{
+    entries.push_back({ _hash, _quiet });
+    ++filter[slotOf(_hash)];
+}
+
+int SearchPath::repetitions() const
+{
+    const auto hash = currentHash();
+    if(filter[slotOf(hash)] < 2)
+        return 1;
+
+    // Earlier occurrences have the same side to move and lie after the last irreversible
+    // move, so at most quietPlyLimit / 2 entries are compared.
+    int count = 1;
+    const int last = static_cast<int>(entries.size()) - 1;
+    for (int i = last - 2; i >= last - quietPlies(); i -= 2) {
+        if(entries[i].hash == hash)
+            ++count;
+    }
+    return count;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "position.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+// One game line with the draw rules applied to its last position. Repetitions can only occur
+// since the last capture or man move, so a game keeps the current position and the hashes of
+// the plies since then, which the quiet-move limit bounds, instead of every earlier position.
+// A count per hash over the same plies answers repetitions() without a scan.
+class GameHistory
+{
+public:
+    enum class Outcome : quint8 { Ongoing, WhiteWins, BlackWins, Repetition, MoveLimit };
+
+    explicit GameHistory(const Position &_start = Position::initial());
+
+    void reset(const Position &_start);
+    void setQuietMoveLimit(const int _moves);
+
+    void push(const Position &_position);
+    void play(const Position::Move &_move) { push(position.play(_move)); }
+
+    const Position& current() const { return position; }
+    quint64 currentHash() const { return hashes.back(); }
+    int plies() const { return plyCount; }
+    int quietPlies() const { return static_cast<int>(hashes.size()) - 1; }
+    int quietPlyLimit() const { return quietLimit; }
+    // The hashes since the last irreversible ply, oldest first and the current position last.
+    const std::vector<quint64>& reversibleHashes() const { return hashes; }
+
+    int repetitions() const { return counts.at(currentHash()); }
+    bool isDraw() const { return quietPlies() >= quietLimit || repetitions() > 1; }
+    Outcome outcome() const;
+
+    static bool isIrreversible(const Position &_before, const Position &_after);
+    static const char* outcomeName(const Outcome _outcome);
+
+private:
+    Position position;
+    std::vector<quint64> hashes;
+    std::unordered_map<quint64, int> counts;
+    int plyCount;
+    int quietLimit;
+};
+
+// The game line below the search root. push() and pop() follow the search, and a counting
+// filter over the hash bits lets almost every node skip the repetition scan, so each check
+// is O(1) per ply; only the engine pays for the filter.
+class SearchPath
+{
+public:
+    SearchPath();
+
+    void reset(const Position &_root);
+    void reset(const GameHistory &_history);
+
+    void push(const Position &_parent, const Position &_child);
+    void pop();
+
+    quint64 currentHash() const { return entries.back().hash; }
+    int quietPlies() const { return entries.back().quiet; }
+
+    int repetitions() const;
+    // The search treats the first repetition or a reached move limit as a draw.
+    bool isDraw() const { return quietPlies() >= quietPlyLimit || repetitions() > 1; }
+
+private:
+    static constexpr int filterBits = 10;
+
+    struct Entry
+    {
+        quint64 hash;
+        int quiet;
+    };
+
+    static int slotOf(const quint64 _hash) { return static_cast<int>(_hash >> (64 - filterBits)); }
+    void append(const quint64 _hash, const int _quiet);
+
+private:
+    std::vector<Entry> entries;
+    std::array<quint16, 1 << filterBits> filter;
+    int quietPlyLimit;
+};
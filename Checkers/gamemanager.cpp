@@ -1,21 +1,106 @@
-#include "gamemanager.hpp"
-
-GameManager::GameManager(QObject *_parent) : QObject(_parent)
-{}
-
-void GameManager::start()
-{
-    started = true;
-    emit nextMove(type);
-}
-
-void GameManager::finish()
-{
-    started = false;
-}
-
-void GameManager::onEndOfMove()
-{
-    type = (type == type_t::White ? type_t::Black : type_t::White);
-    emit nextMove(type);
-}
+#include "gamemanager.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+
+namespace {
+const Metrics::Histogram turnDuration("checkers_turn_seconds", "Time from the start of a turn until the move is completed.");
+const Metrics::Counter turnsPlayed("checkers_turns_total", "Turns completed.");
+
+const Metrics::Counter gamesWon("checkers_games_finished_total", "Games ended by the game rules.", "result=\"win\"");
+const Metrics::Counter gamesRepeated("checkers_games_finished_total", "Games ended by the game rules.", "result=\"repetition\"");
+const Metrics::Counter gamesAtMoveLimit("checkers_games_finished_total", "Games ended by the game rules.", "result=\"move-limit\"");
+
+const Metrics::Counter& gamesFinished(const GameHistory::Outcome _outcome)
+{
+    if(_outcome == GameHistory::Outcome::Repetition)
+        return gamesRepeated;
+    if(_outcome == GameHistory::Outcome::MoveLimit)
+        return gamesAtMoveLimit;
+    return gamesWon;
+}
+}
+
+GameManager::GameManager(QObject *_parent) : QObject(_parent)
+{}
+
+void GameManager::start()
+{
+    started = true;
+    finished = false;
+    turnTimer.start();
+    announceTurn();
+}
+
+void GameManager::finish()
+{
+    started = false;
+}
+
+bool GameManager::isFinished() const
+{
+    return finished;
+}
+
+void GameManager::resetHistory(const Position &_start)
+{
+    positions.reset(_start);
+    type = _start.sideToMove() == Position::Side::White ? type_t::White : type_t::Black;
+}
+
+const GameHistory &GameManager::history() const
+{
+    return positions;
+}
+
+void GameManager::onEndOfMove(const Position &_position)
+{
+    TRACE_SPAN("GameManager::onEndOfMove");
+    if(turnTimer.isValid()) {
+        turnDuration.observe(turnTimer.nsecsElapsed());
+        turnsPlayed.add();
+    }
+    turnTimer.start();
+
+    type = (type == type_t::White ? type_t::Black : type_t::White);
+    positions.push(_position);
+
+    const auto outcome = positions.outcome();
+    if(outcome != GameHistory::Outcome::Ongoing) {
+        endGame(outcome);
+        return;
+    }
+    announceTurn();
+}
+
+void GameManager::onNoMoves(type_t _type)
+{
+    endGame(_type == type_t::White ? GameHistory::Outcome::BlackWins : GameHistory::Outcome::WhiteWins);
+}
+
+void GameManager::setEngineSide(type_t _side)
+{
+    engineEnabled = true;
+    engineSide = _side;
+}
+
+void GameManager::announceTurn()
+{
+    if(!started)
+        return;
+
+    if(engineEnabled && type == engineSide)
+        emit engineToMove(type);
+    else
+        emit nextMove(type);
+}
+
+void GameManager::endGame(GameHistory::Outcome _outcome)
+{
+    if(finished)
+        return;
+
+    finish();
+    finished = true;
+    gamesFinished(_outcome).add();
+    emit gameOver(_outcome);
+}
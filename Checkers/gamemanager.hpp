@@ -1,28 +1,46 @@
-#pragma once
-
-#include "checker.hpp"
-
-#include <QObject>
-
-class GameManager : public QObject
-{
-    Q_OBJECT
-    using type_t = Checker::Type;
-public:
-    GameManager(QObject *_parent = nullptr);
-
-    void start();
-    void finish();
-
-signals:
-    void nextMove(type_t _type);
-
-public slots:
-    void onEndOfMove();
-
-private:
-
-    bool started = false;
-    type_t type = type_t::White;
-};
-
+#pragma once
+
+#include "checker.hpp"
+#include "gamehistory.hpp"
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class GameManager : public QObject
+{
+    Q_OBJECT
+    using type_t = Checker::Type;
+public:
+    GameManager(QObject *_parent = nullptr);
+
+    void start();
+    void finish();
+    bool isFinished() const;
+
+    void setEngineSide(type_t _side);
+    void resetHistory(const Position &_start);
+    const GameHistory& history() const;
+
+signals:
+    void nextMove(type_t _type);
+    void engineToMove(type_t _type);
+    void gameOver(GameHistory::Outcome _outcome);
+
+public slots:
+    // _position is the board after the move, with the opponent to move.
+    void onEndOfMove(const Position &_position);
+    void onNoMoves(type_t _type);
+
+private:
+    void announceTurn();
+    void endGame(GameHistory::Outcome _outcome);
+
+private:
+    bool started = false;
+    bool finished = false;
+    bool engineEnabled = false;
+    type_t engineSide = type_t::Black;
+    type_t type = type_t::White;
+    QElapsedTimer turnTimer;
+    GameHistory positions;
+};
@@ -0,0 +1,33 @@
+#include "gamereplay.hpp"
+
+#include <algorithm>
+
+GameReplay::GameReplay()
+    : keyframes(1, Position::initial())
+    , keyframeInterval(defaultKeyframeInterval)
+{}
+
+GameReplay::GameReplay(const Position &_start, const std::vector<Position::Move> &_moves, const int _keyframeInterval)
+    : moves(_moves)
+    , keyframeInterval(std::max(_keyframeInterval, 1))
+{
+    keyframes.reserve(moves.size() / keyframeInterval + 1);
+    auto position = _start;
+    for (int ply = 0; ply < plyCount(); ++ply) {
+        if(ply % keyframeInterval == 0)
+            keyframes.push_back(position);
+        position = position.play(moves[ply]);
+    }
+    if(plyCount() % keyframeInterval == 0)
+        keyframes.push_back(position);
+}
+
+Position GameReplay::positionAt(const int _ply) const
+{
+    const auto ply = std::min(std::max(_ply, 0), plyCount());
+    const auto keyframe = ply / keyframeInterval;
+    auto position = keyframes[keyframe];
+    for (int i = keyframe * keyframeInterval; i < ply; ++i)
+        position = position.play(moves[i]);
+    return position;
+}
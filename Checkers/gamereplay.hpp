@@ -0,0 +1,26 @@
+#pragma once
+
+#include "position.hpp"
+
+#include <vector>
+
+// Random access to the positions of a recorded game. A full Position is kept every
+// keyframeInterval plies, so positionAt() replays at most keyframeInterval - 1 moves.
+class GameReplay
+{
+public:
+    static constexpr int defaultKeyframeInterval = 16;
+
+    GameReplay();
+    GameReplay(const Position &_start, const std::vector<Position::Move> &_moves, const int _keyframeInterval = defaultKeyframeInterval);
+
+    int plyCount() const { return static_cast<int>(moves.size()); }
+    const Position::Move& move(const int _ply) const { return moves[_ply]; }
+    // The position before move _ply is played; _ply == plyCount() is the final position.
+    Position positionAt(const int _ply) const;
+
+private:
+    std::vector<Position::Move> moves;
+    std::vector<Position> keyframes;
+    int keyframeInterval;
+};
@@ -0,0 +1,231 @@
+#include "gameserver.hpp"
+#include "metrics.hpp"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <functional>
+
+namespace {
+
+const Metrics::Counter requestsHandled("checkers_server_requests_total", "Requests handled by the game server.");
+const Metrics::Counter movesPlayed("checkers_server_moves_total", "Moves applied to server sessions.");
+const Metrics::Histogram requestDuration("checkers_server_request_seconds", "Time spent handling one server request.");
+
+class RequestTask : public QRunnable
+{
+public:
+    RequestTask(GameServer *_server, QObject *_receiver, const QByteArray &_line,
+                std::function<void(const QByteArray&)> _deliver)
+        : server(_server)
+        , receiver(_receiver)
+        , line(_line)
+        , deliver(std::move(_deliver))
+    {}
+
+    void run() override
+    {
+        const auto reply = server->handleRequest(line);
+        auto deliverReply = deliver;
+        QMetaObject::invokeMethod(receiver, [deliverReply, reply]() { deliverReply(reply); }, Qt::QueuedConnection);
+    }
+
+private:
+    GameServer *server;
+    QObject *receiver;
+    QByteArray line;
+    std::function<void(const QByteArray&)> deliver;
+};
+
+QByteArray fenOf(const Position &_position)
+{
+    return QByteArray::fromStdString(_position.toFen());
+}
+
+}
+
+quint32 SessionStore::create(const Position &_position)
+{
+    const auto id = nextId.fetch_add(1, std::memory_order_relaxed);
+    auto& shard = shardFor(id);
+    QMutexLocker locker(&shard.mutex);
+    auto& session = shard.sessions[id];
+    session.history.reset(_position);
+    return id;
+}
+
+bool SessionStore::remove(const quint32 _id)
+{
+    auto& shard = shardFor(_id);
+    QMutexLocker locker(&shard.mutex);
+    return shard.sessions.erase(_id) > 0;
+}
+
+int SessionStore::size() const
+{
+    int total = 0;
+    for (const auto& shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        total += static_cast<int>(shard.sessions.size());
+    }
+    return total;
+}
+
+GameServer::GameServer(const int _threads, QObject *_parent)
+    : QObject(_parent)
+    , server(new QLocalServer(this))
+{
+    pool.setMaxThreadCount(_threads);
+    connect(server, &QLocalServer::newConnection, this, &GameServer::onNewConnection);
+}
+
+GameServer::~GameServer()
+{
+    pool.waitForDone();
+}
+
+bool GameServer::listen(const QString &_name)
+{
+    QLocalServer::removeServer(_name);
+    return server->listen(_name);
+}
+
+void GameServer::onNewConnection()
+{
+    while(auto socket = server->nextPendingConnection())
+        new ServerConnection(socket, this, &pool);
+}
+
+QByteArray GameServer::handleRequest(const QByteArray &_line)
+{
+    QElapsedTimer timer;
+    timer.start();
+    requestsHandled.add();
+
+    const auto words = _line.simplified().split(' ');
+    const auto& command = words.value(0);
+    const auto id = words.value(1).toUInt();
+    QByteArray reply;
+
+    if(command == "new") {
+        const auto edge = words.size() > 1 ? words[1].toInt() : 8;
+        if(edge != 8 && edge != 10)
+            return "error unsupported board size";
+        const auto position = Position::initial(edge);
+        const auto newId = sessions.create(position);
+        reply = "ok " + QByteArray::number(newId) + ' ' + fenOf(position);
+    }
+    else if(command == "state") {
+        if(!sessions.update(id, [&](GameSession &_session) {
+            reply = "ok " + fenOf(_session.history.current()) + " ply=" + QByteArray::number(_session.history.plies());
+        }))
+            reply = "error unknown session";
+    }
+    else if(command == "moves") {
+        if(!sessions.update(id, [&](GameSession &_session) {
+            const auto& position = _session.history.current();
+            Position::MoveList moves;
+            position.generateMoves(moves);
+            reply = "ok";
+            for (const auto& move : moves)
+                reply += ' ' + QByteArray::fromStdString(position.moveToString(move));
+        }))
+            reply = "error unknown session";
+    }
+    else if(command == "play") {
+        const auto text = words.value(2).toStdString();
+        if(!sessions.update(id, [&](GameSession &_session) {
+            Position::Move move;
+            if(_session.finished) {
+                reply = "error game over";
+                return;
+            }
+            if(!_session.history.current().parseMove(text, move)) {
+                reply = "error illegal move";
+                return;
+            }
+            _session.history.play(move);
+            movesPlayed.add();
+
+            reply = "ok " + fenOf(_session.history.current());
+            const auto outcome = _session.history.outcome();
+            if(outcome != GameHistory::Outcome::Ongoing) {
+                _session.finished = true;
+                reply += QByteArray(" result ") + GameHistory::outcomeName(outcome);
+            }
+        }))
+            reply = "error unknown session";
+    }
+    else if(command == "close") {
+        reply = sessions.remove(id) ? "ok" : "error unknown session";
+    }
+    else if(command == "stats") {
+        reply = "ok sessions=" + QByteArray::number(sessions.size());
+    }
+    else {
+        reply = "error unknown command";
+    }
+
+    requestDuration.observe(timer.nsecsElapsed());
+    return reply;
+}
+
+ServerConnection::ServerConnection(QLocalSocket *_socket, GameServer *_server, QThreadPool *_pool)
+    : QObject(_socket)
+    , socket(_socket)
+    , server(_server)
+    , pool(_pool)
+    , busy(false)
+    , closing(false)
+{
+    connect(socket, &QLocalSocket::readyRead, this, &ServerConnection::onReadyRead);
+    connect(socket, &QLocalSocket::disconnected, this, &ServerConnection::onDisconnected);
+}
+
+void ServerConnection::onReadyRead()
+{
+    while(socket->canReadLine()) {
+        const auto line = socket->readLine().trimmed();
+        if(!line.isEmpty())
+            pending.enqueue(line);
+    }
+    dispatch();
+}
+
+void ServerConnection::onDisconnected()
+{
+    // A running task still holds a pointer to this connection; defer deletion until it replies.
+    pending.clear();
+    if(busy)
+        closing = true;
+    else
+        socket->deleteLater();
+}
+
+void ServerConnection::dispatch()
+{
+    // One request per connection is in flight at a time, so replies keep request order;
+    // different connections are served in parallel by the pool.
+    if(busy || pending.isEmpty())
+        return;
+
+    busy = true;
+    pool->start(new RequestTask(server, this, pending.dequeue(), [this](const QByteArray &_reply) {
+        onReply(_reply);
+    }));
+}
+
+void ServerConnection::onReply(const QByteArray &_reply)
+{
+    if(closing) {
+        socket->deleteLater();
+        return;
+    }
+
+    socket->write(_reply + '\n');
+    busy = false;
+    dispatch();
+}
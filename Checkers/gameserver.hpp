@@ -0,0 +1,99 @@
+#pragma once
+
+#include "gamehistory.hpp"
+
+#include <QObject>
+#include <QMutex>
+#include <QQueue>
+#include <QThreadPool>
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
+class QLocalServer;
+class QLocalSocket;
+
+struct GameSession
+{
+    GameHistory history;
+    bool finished = false;
+};
+
+class SessionStore
+{
+public:
+    static constexpr int shardCount = 64;
+
+    quint32 create(const Position &_position);
+    bool remove(const quint32 _id);
+    int size() const;
+
+    template<typename Function>
+    bool update(const quint32 _id, Function &&_function)
+    {
+        auto& shard = shardFor(_id);
+        QMutexLocker locker(&shard.mutex);
+        auto it = shard.sessions.find(_id);
+        if(it == shard.sessions.end())
+            return false;
+        _function(it->second);
+        return true;
+    }
+
+private:
+    struct Shard
+    {
+        mutable QMutex mutex;
+        std::unordered_map<quint32, GameSession> sessions;
+    };
+
+    Shard& shardFor(const quint32 _id) { return shards[_id % shardCount]; }
+
+private:
+    std::array<Shard, shardCount> shards;
+    std::atomic<quint32> nextId{1};
+};
+
+class GameServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit GameServer(const int _threads, QObject *_parent = nullptr);
+    ~GameServer() override;
+
+    bool listen(const QString &_name);
+
+    QByteArray handleRequest(const QByteArray &_line);
+
+private slots:
+    void onNewConnection();
+
+private:
+    QLocalServer *server;
+    QThreadPool pool;
+    SessionStore sessions;
+};
+
+class ServerConnection : public QObject
+{
+    Q_OBJECT
+public:
+    ServerConnection(QLocalSocket *_socket, GameServer *_server, QThreadPool *_pool);
+
+private slots:
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    void dispatch();
+    void onReply(const QByteArray &_reply);
+
+private:
+    QLocalSocket *socket;
+    GameServer *server;
+    QThreadPool *pool;
+    QQueue<QByteArray> pending;
+    bool busy;
+    bool closing;
+};
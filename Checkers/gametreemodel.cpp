@@ -0,0 +1,195 @@
+#include "gametreemodel.hpp"
+
+#include <algorithm>
+
+namespace {
+
+const int fetchBatch = 256;
+
+QString scoreText(const int _score)
+{
+    if(_score > Engine::winScore - Engine::maxDepth * 2)
+        return QString("+W%1").arg(Engine::winScore - _score);
+    if(_score < -Engine::winScore + Engine::maxDepth * 2)
+        return QString("-W%1").arg(Engine::winScore + _score);
+    return QString::number(_score / 100.0, 'f', 2);
+}
+
+}
+
+GameTreeModel::GameTreeModel(const int _boardEdgeSize, QObject *_parent)
+    : QAbstractItemModel(_parent)
+    , geometry(_boardEdgeSize)
+{
+    fetched.insert(AnalysisTree::rootNode, QVector<quint32>());
+}
+
+void GameTreeModel::clear()
+{
+    beginResetModel();
+    analysis.clear();
+    fetched.clear();
+    fetched.insert(AnalysisTree::rootNode, QVector<quint32>());
+    endResetModel();
+}
+
+bool GameTreeModel::isVisible(const quint32 _node) const
+{
+    if(_node == AnalysisTree::rootNode)
+        return true;
+    const auto& node = analysis.node(_node);
+    const auto siblings = fetched.constFind(node.parent);
+    return siblings != fetched.cend() && static_cast<int>(node.row) < siblings->size();
+}
+
+quint32 GameTreeModel::addMove(const quint32 _parent, const Position::Move &_move)
+{
+    const auto wasLeaf = analysis.node(_parent).childCount == 0;
+    const auto siblings = fetched.find(_parent);
+    const bool appendNow = siblings != fetched.end() && siblings->size() == static_cast<int>(analysis.node(_parent).childCount);
+
+    bool created = false;
+    const auto id = analysis.addChild(_parent, _move, &created);
+    if(!created)
+        return id;
+
+    // Fully fetched parents grow immediately; others pick the row up on their next fetchMore().
+    if(appendNow) {
+        const auto row = siblings->size();
+        beginInsertRows(indexOf(_parent), row, row);
+        fetched[_parent].append(id);
+        endInsertRows();
+    }
+    else if(wasLeaf && isVisible(_parent)) {
+        const auto index = indexOf(_parent);
+        emit dataChanged(index, index);
+    }
+    return id;
+}
+
+void GameTreeModel::addAnalysis(const quint32 _node, const Position &_position, const Engine::Result &_result)
+{
+    auto node = _node;
+    auto position = _position;
+    int score = _result.score;
+    for (size_t ply = 0; ply < _result.pv.size(); ++ply) {
+        node = addMove(node, _result.pv[ply]);
+        // Scores are stored from White's point of view so sibling rows compare directly.
+        const auto whiteScore = position.sideToMove() == Position::Side::White ? score : -score;
+        analysis.setEvaluation(node, whiteScore, std::max(_result.depth - static_cast<int>(ply), 0), ply == 0 ? _result.nodes : 0);
+        if(isVisible(node))
+            emit dataChanged(indexOf(node, ScoreColumn), indexOf(node, NodesColumn));
+
+        position = position.play(_result.pv[ply]);
+        score = -score;
+    }
+}
+
+QModelIndex GameTreeModel::indexOf(const quint32 _node, const int _column) const
+{
+    if(_node == AnalysisTree::rootNode || !isVisible(_node))
+        return QModelIndex();
+    return createIndex(static_cast<int>(analysis.node(_node).row), _column, _node);
+}
+
+quint32 GameTreeModel::nodeOf(const QModelIndex &_index) const
+{
+    return _index.isValid() ? static_cast<quint32>(_index.internalId()) : AnalysisTree::rootNode;
+}
+
+QModelIndex GameTreeModel::index(int _row, int _column, const QModelIndex &_parent) const
+{
+    const auto children = fetched.constFind(nodeOf(_parent));
+    if(children == fetched.cend() || _row < 0 || _row >= children->size() || _column < 0 || _column >= ColumnCount)
+        return QModelIndex();
+    return createIndex(_row, _column, children->at(_row));
+}
+
+QModelIndex GameTreeModel::parent(const QModelIndex &_child) const
+{
+    if(!_child.isValid())
+        return QModelIndex();
+    return indexOf(analysis.node(nodeOf(_child)).parent);
+}
+
+int GameTreeModel::rowCount(const QModelIndex &_parent) const
+{
+    if(_parent.column() > 0)
+        return 0;
+    const auto children = fetched.constFind(nodeOf(_parent));
+    return children == fetched.cend() ? 0 : children->size();
+}
+
+int GameTreeModel::columnCount(const QModelIndex &_parent) const
+{
+    Q_UNUSED(_parent);
+    return ColumnCount;
+}
+
+bool GameTreeModel::hasChildren(const QModelIndex &_parent) const
+{
+    if(_parent.column() > 0)
+        return false;
+    return analysis.node(nodeOf(_parent)).childCount > 0;
+}
+
+bool GameTreeModel::canFetchMore(const QModelIndex &_parent) const
+{
+    if(_parent.column() > 0)
+        return false;
+    const auto id = nodeOf(_parent);
+    const auto children = fetched.constFind(id);
+    const int available = static_cast<int>(analysis.node(id).childCount);
+    return children == fetched.cend() ? available > 0 : children->size() < available;
+}
+
+void GameTreeModel::fetchMore(const QModelIndex &_parent)
+{
+    const auto id = nodeOf(_parent);
+    auto& children = fetched[id];
+    auto next = children.isEmpty() ? analysis.node(id).firstChild : analysis.node(children.last()).nextSibling;
+    if(next == AnalysisTree::none)
+        return;
+
+    const int available = static_cast<int>(analysis.node(id).childCount);
+    const int count = std::min(fetchBatch, available - children.size());
+    beginInsertRows(_parent, children.size(), children.size() + count - 1);
+    children.reserve(children.size() + count);
+    for (int i = 0; i < count && next != AnalysisTree::none; ++i) {
+        children.append(next);
+        next = analysis.node(next).nextSibling;
+    }
+    endInsertRows();
+}
+
+QVariant GameTreeModel::data(const QModelIndex &_index, int _role) const
+{
+    if(!_index.isValid() || (_role != Qt::DisplayRole && _role != Qt::TextAlignmentRole))
+        return QVariant();
+
+    if(_role == Qt::TextAlignmentRole)
+        return _index.column() == MoveColumn ? QVariant() : QVariant(int(Qt::AlignRight | Qt::AlignVCenter));
+
+    const auto& node = analysis.node(nodeOf(_index));
+    switch (_index.column()) {
+    case MoveColumn: return QString::fromStdString(geometry.moveToString(node.move));
+    case ScoreColumn: return node.evaluated ? scoreText(node.score) : QVariant();
+    case DepthColumn: return node.evaluated ? QVariant(node.depth) : QVariant();
+    case NodesColumn: return node.nodes ? QVariant(node.nodes) : QVariant();
+    default: return QVariant();
+    }
+}
+
+QVariant GameTreeModel::headerData(int _section, Qt::Orientation _orientation, int _role) const
+{
+    if(_orientation != Qt::Horizontal || _role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (_section) {
+    case MoveColumn: return tr("Move");
+    case ScoreColumn: return tr("Score");
+    case DepthColumn: return tr("Depth");
+    case NodesColumn: return tr("Nodes");
+    default: return QVariant();
+    }
+}
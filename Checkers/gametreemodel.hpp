@@ -0,0 +1,48 @@
+#pragma once
+
+#include "analysistree.hpp"
+#include "engine.hpp"
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
+
+// Exposes an AnalysisTree to item views. Children are handed out through canFetchMore()/fetchMore()
+// in batches, so only rows a view has actually expanded or scrolled to get model indexes.
+class GameTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Column { MoveColumn, ScoreColumn, DepthColumn, NodesColumn, ColumnCount };
+
+    explicit GameTreeModel(const int _boardEdgeSize = 8, QObject *_parent = nullptr);
+
+    const AnalysisTree& tree() const { return analysis; }
+    void clear();
+
+    quint32 addMove(const quint32 _parent, const Position::Move &_move);
+    // Adds the principal variation of _result below _node; _position is the position searched.
+    void addAnalysis(const quint32 _node, const Position &_position, const Engine::Result &_result);
+
+    QModelIndex indexOf(const quint32 _node, const int _column = 0) const;
+    quint32 nodeOf(const QModelIndex &_index) const;
+
+    QModelIndex index(int _row, int _column, const QModelIndex &_parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &_child) const override;
+    int rowCount(const QModelIndex &_parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &_parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &_parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &_parent) const override;
+    void fetchMore(const QModelIndex &_parent) override;
+    QVariant data(const QModelIndex &_index, int _role = Qt::DisplayRole) const override;
+    QVariant headerData(int _section, Qt::Orientation _orientation, int _role = Qt::DisplayRole) const override;
+
+private:
+    bool isVisible(const quint32 _node) const;
+
+private:
+    AnalysisTree analysis;
+    // Materialized children per fetched parent; nodes outside this map have no model indexes.
+    QHash<quint32, QVector<quint32>> fetched;
+    const Position geometry;
+};
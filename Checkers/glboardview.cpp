@@ -0,0 +1,284 @@
+#include "glboardview.hpp"
+#include "checkerboard.hpp"
+#include "cell.hpp"
+#include "king.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QVector2D>
+
+namespace {
+
+const Metrics::Histogram glFrameDuration("checkers_gl_frame_seconds", "Time spent building and submitting one OpenGL board frame.");
+
+const int atlasTileSize = 128;
+const int floatsPerVertex = 4;
+
+const char *vertexShaderSource =
+        "attribute vec2 position;\n"
+        "attribute vec2 texCoord;\n"
+        "uniform vec2 viewport;\n"
+        "varying vec2 uv;\n"
+        "void main() {\n"
+        "    uv = texCoord;\n"
+        "    gl_Position = vec4(position.x / viewport.x * 2.0 - 1.0, 1.0 - position.y / viewport.y * 2.0, 0.0, 1.0);\n"
+        "}\n";
+
+const char *fragmentShaderSource =
+        "uniform sampler2D atlas;\n"
+        "varying vec2 uv;\n"
+        "void main() {\n"
+        "    gl_FragColor = texture2D(atlas, uv);\n"
+        "}\n";
+
+QImage pieceImage(const QString &_resource, int _size)
+{
+    return Checker::loadImage(_resource).scaled(_size, _size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+}
+
+GLBoardView::GLBoardView(Checkerboard *_board, QWidget *_parent)
+    : QOpenGLWidget(_parent)
+    , board(_board)
+    , vertexBuffer(QOpenGLBuffer::VertexBuffer)
+{
+    setFocusPolicy(Qt::ClickFocus);
+    setMinimumSize(256, 256);
+    connect(board, &Checkerboard::endOfMove, this, static_cast<void (QWidget::*)()>(&QWidget::update));
+}
+
+GLBoardView::~GLBoardView()
+{
+    makeCurrent();
+    atlas.reset();
+    program.reset();
+    vertexBuffer.destroy();
+    doneCurrent();
+}
+
+QSize GLBoardView::sizeHint() const
+{
+    return QSize(64, 64) * board->getBoardSize();
+}
+
+QImage GLBoardView::buildAtlas(int _tileSize)
+{
+    QImage image(_tileSize * TileCount, _tileSize, QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+
+    const QColor dark(Qt::black);
+    auto tileRect = [&](Tile _tile) { return QRect(_tile * _tileSize, 0, _tileSize, _tileSize); };
+    auto highlight = [&](Tile _tile, const QColor &_mainColor, bool _ringsOnly) {
+        const auto rect = tileRect(_tile);
+        QRadialGradient grad(rect.center(), _tileSize / 2);
+        if(_ringsOnly) {
+            grad.setColorAt(0.9, _mainColor);
+            grad.setColorAt(1, dark);
+        }
+        else {
+            grad.setColorAt(0.15, _mainColor);
+            grad.setColorAt(0.3, dark);
+            grad.setColorAt(0.55, _mainColor);
+            grad.setColorAt(0.7, dark);
+            grad.setColorAt(0.9, _mainColor);
+            grad.setColorAt(1, dark);
+        }
+        painter.fillRect(rect, dark);
+        painter.setBrush(grad);
+        painter.drawRect(rect);
+    };
+
+    painter.fillRect(tileRect(LightSquare), QColor(Qt::white));
+    painter.fillRect(tileRect(DarkSquare), dark);
+    highlight(MoveSquare, Qt::green, false);
+    highlight(JumpSquare, Qt::red, false);
+    highlight(BacklitSquare, Qt::green, true);
+
+    painter.drawImage(tileRect(WhiteMan), pieceImage(":/qrc/resources/images/white checker.bmp", _tileSize));
+    painter.drawImage(tileRect(BlackMan), pieceImage(":/qrc/resources/images/black checker.bmp", _tileSize));
+    painter.drawImage(tileRect(WhiteKing), pieceImage(":/qrc/resources/images/white king.bmp", _tileSize));
+    painter.drawImage(tileRect(BlackKing), pieceImage(":/qrc/resources/images/black king.bmp", _tileSize));
+    return image;
+}
+
+void GLBoardView::initializeGL()
+{
+    initializeOpenGLFunctions();
+
+    program = std::make_unique<QOpenGLShaderProgram>();
+    program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource);
+    program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
+    program->bindAttributeLocation("position", 0);
+    program->bindAttributeLocation("texCoord", 1);
+    if(!program->link())
+        qWarning("GLBoardView: shader link failed: %s", qPrintable(program->log()));
+
+    atlas = std::make_unique<QOpenGLTexture>(buildAtlas(atlasTileSize));
+    atlas->setMinificationFilter(QOpenGLTexture::Linear);
+    atlas->setMagnificationFilter(QOpenGLTexture::Linear);
+    atlas->setWrapMode(QOpenGLTexture::ClampToEdge);
+
+    vertexBuffer.create();
+    vertexBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void GLBoardView::resizeGL(int _width, int _height)
+{
+    Q_UNUSED(_width);
+    Q_UNUSED(_height);
+}
+
+QRectF GLBoardView::boardRect() const
+{
+    const auto side = qMin(width(), height());
+    return QRectF((width() - side) / 2.0, (height() - side) / 2.0, side, side);
+}
+
+void GLBoardView::appendQuad(const QRectF &_rect, Tile _tile)
+{
+    // Texture coordinates stop half a texel inside the tile, so linear filtering never samples
+    // the neighbouring sprite when the board is drawn at other than the atlas tile size.
+    const GLfloat atlasWidth = GLfloat(atlasTileSize * TileCount);
+    const GLfloat u0 = (_tile * atlasTileSize + 0.5f) / atlasWidth;
+    const GLfloat u1 = ((_tile + 1) * atlasTileSize - 0.5f) / atlasWidth;
+    const GLfloat v0 = 0.5f / atlasTileSize;
+    const GLfloat v1 = 1.0f - v0;
+    const GLfloat x0 = _rect.left(), y0 = _rect.top(), x1 = _rect.right(), y1 = _rect.bottom();
+
+    const GLfloat quad[] = {
+        x0, y0, u0, v0,   x1, y0, u1, v0,   x1, y1, u1, v1,
+        x0, y0, u0, v0,   x1, y1, u1, v1,   x0, y1, u0, v1
+    };
+    for (auto value : quad)
+        vertices.append(value);
+}
+
+void GLBoardView::paintGL()
+{
+    TRACE_SPAN("GLBoardView::paintGL");
+    QElapsedTimer timer;
+    timer.start();
+
+    glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    const auto edge = board->getBoardSize();
+    const auto area = boardRect();
+    const auto squareSize = area.width() / edge;
+
+    vertices.clear();
+    vertices.reserve(edge * edge * 2 * 6 * floatsPerVertex);
+
+    const auto cells = board->findChildren<Cell*>();
+    appendQuad(area, LightSquare);
+    // The light tile is stretched over the whole board; dark squares and pieces are drawn on top.
+    for (auto cell : cells) {
+        const auto& index = cell->getIndex();
+        const auto layoutCol = index.second * 2 + (index.first % 2 != 0 ? 0 : 1);
+        const QRectF rect(area.left() + layoutCol * squareSize, area.top() + index.first * squareSize, squareSize, squareSize);
+
+        Tile square = DarkSquare;
+        if(cell->isOpenForJump())
+            square = JumpSquare;
+        else if(cell->isOpenForMove())
+            square = MoveSquare;
+        else if(cell->hasBacklight())
+            square = BacklitSquare;
+        appendQuad(rect, square);
+
+        if(cell->hasChecker()) {
+            const auto& checker = cell->getChecker();
+            const bool king = dynamic_cast<King*>(checker.get()) != nullptr;
+            const bool white = checker->getType() == Checker::Type::White;
+            appendQuad(rect, white ? (king ? WhiteKing : WhiteMan) : (king ? BlackKing : BlackMan));
+        }
+    }
+
+    const auto ratio = devicePixelRatioF();
+    glViewport(0, 0, int(width() * ratio), int(height() * ratio));
+
+    program->bind();
+    program->setUniformValue("viewport", QVector2D(width(), height()));
+    program->setUniformValue("atlas", 0);
+    atlas->bind(0);
+
+    vertexBuffer.bind();
+    vertexBuffer.allocate(vertices.constData(), vertices.size() * int(sizeof(GLfloat)));
+    program->enableAttributeArray(0);
+    program->enableAttributeArray(1);
+    program->setAttributeBuffer(0, GL_FLOAT, 0, 2, floatsPerVertex * sizeof(GLfloat));
+    program->setAttributeBuffer(1, GL_FLOAT, 2 * sizeof(GLfloat), 2, floatsPerVertex * sizeof(GLfloat));
+
+    // Every square, highlight and checker goes out in this single batched call.
+    glDrawArrays(GL_TRIANGLES, 0, vertices.size() / floatsPerVertex);
+
+    program->disableAttributeArray(0);
+    program->disableAttributeArray(1);
+    vertexBuffer.release();
+    atlas->release();
+    program->release();
+
+    glFrameDuration.observe(timer.nsecsElapsed());
+}
+
+Cell *GLBoardView::cellAt(const QPoint &_pos) const
+{
+    const auto area = boardRect();
+    if(!area.contains(_pos))
+        return nullptr;
+
+    const auto edge = board->getBoardSize();
+    const auto squareSize = area.width() / edge;
+    const int row = int((_pos.y() - area.top()) / squareSize);
+    const int layoutCol = int((_pos.x() - area.left()) / squareSize);
+
+    const bool darkSquare = (row % 2 != 0) ? (layoutCol % 2 == 0) : (layoutCol % 2 != 0);
+    if(!darkSquare)
+        return nullptr;
+
+    const Checker::index_t index(row, layoutCol / 2);
+    for (auto cell : board->findChildren<Cell*>()) {
+        if(cell->getIndex() == index)
+            return cell;
+    }
+    return nullptr;
+}
+
+void GLBoardView::mousePressEvent(QMouseEvent *_event)
+{
+    TRACE_SPAN("GLBoardView::mousePressEvent");
+    QOpenGLWidget::mousePressEvent(_event);
+
+    // Input still goes through Cell so selection and move rules stay in one place.
+    if(auto cell = cellAt(_event->pos())) {
+        QMouseEvent forwarded(_event->type(), QPointF(1, 1), _event->screenPos(),
+                              _event->button(), _event->buttons(), _event->modifiers());
+        QApplication::sendEvent(cell, &forwarded);
+    }
+    update();
+}
+
+void GLBoardView::keyPressEvent(QKeyEvent *_event)
+{
+    QOpenGLWidget::keyPressEvent(_event);
+
+    for (auto cell : board->findChildren<Cell*>()) {
+        if(cell->isSelected()) {
+            QKeyEvent forwarded(_event->type(), _event->key(), _event->modifiers(), _event->text());
+            QApplication::sendEvent(cell, &forwarded);
+        }
+    }
+    update();
+}
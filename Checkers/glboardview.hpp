@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QOpenGLWidget>
+#include <QOpenGLFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <QVector>
+
+#include <memory>
+
+class Cell;
+class Checkerboard;
+
+class GLBoardView : public QOpenGLWidget, protected QOpenGLFunctions
+{
+    Q_OBJECT
+public:
+    explicit GLBoardView(Checkerboard *_board, QWidget *_parent = nullptr);
+    ~GLBoardView() override;
+
+protected:
+    void initializeGL() override;
+    void resizeGL(int _width, int _height) override;
+    void paintGL() override;
+
+    void mousePressEvent(QMouseEvent *_event) override;
+    void keyPressEvent(QKeyEvent *_event) override;
+    QSize sizeHint() const override;
+
+private:
+    enum Tile { LightSquare, DarkSquare, MoveSquare, JumpSquare, BacklitSquare,
+                WhiteMan, BlackMan, WhiteKing, BlackKing, TileCount };
+
+    static QImage buildAtlas(int _tileSize);
+    QRectF boardRect() const;
+    Cell *cellAt(const QPoint &_pos) const;
+    void appendQuad(const QRectF &_rect, Tile _tile);
+
+private:
+    Checkerboard *board;
+    std::unique_ptr<QOpenGLShaderProgram> program;
+    std::unique_ptr<QOpenGLTexture> atlas;
+    QOpenGLBuffer vertexBuffer;
+    QVector<GLfloat> vertices;
+};
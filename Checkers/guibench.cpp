@@ -0,0 +1,213 @@
+#include "mainwindow.hpp"
+#include "cell.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QTextStream>
+
+#include <algorithm>
+
+namespace {
+
+class PaintCounter : public QObject
+{
+public:
+    int paints = 0;
+    int frames = 0;
+
+protected:
+    bool eventFilter(QObject *_watched, QEvent *_event) override
+    {
+        if(_event->type() == QEvent::Paint && qobject_cast<Cell*>(_watched))
+            ++paints;
+        else if(_event->type() == QEvent::UpdateRequest && _watched->isWidgetType()
+                && static_cast<QWidget*>(_watched)->isWindow())
+            ++frames;
+        return false;
+    }
+};
+
+struct MoveSample
+{
+    int paints;
+    int frames;
+    qint64 nanoseconds;
+};
+
+struct RunResult
+{
+    int boardSize;
+    QSize windowSize;
+    QVector<MoveSample> moves;
+};
+
+void flushEvents()
+{
+    QApplication::processEvents(QEventLoop::AllEvents);
+    QApplication::sendPostedEvents();
+    QApplication::processEvents(QEventLoop::AllEvents);
+}
+
+void click(Cell *_cell)
+{
+    const QPointF center = _cell->rect().center();
+    QMouseEvent press(QEvent::MouseButtonPress, center, _cell->mapToGlobal(center.toPoint()),
+                      Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QApplication::sendEvent(_cell, &press);
+}
+
+Cell *findSource(const QList<Cell*> &_cells)
+{
+    for (auto cell : _cells) {
+        if(cell->isActivated() && cell->hasChecker() && !cell->isOpenForJump() && !cell->isOpenForMove())
+            return cell;
+    }
+    return nullptr;
+}
+
+Cell *findDestination(const QList<Cell*> &_cells)
+{
+    for (auto cell : _cells) {
+        if(cell->isOpenForJump())
+            return cell;
+    }
+    for (auto cell : _cells) {
+        if(cell->isOpenForMove())
+            return cell;
+    }
+    return nullptr;
+}
+
+RunResult playScriptedGame(const int _boardSize, const QSize &_windowSize, const int _maxMoves, const bool _animate, PaintCounter &_counter)
+{
+    RunResult result { _boardSize, _windowSize, {} };
+
+    MainWindow window(_boardSize);
+    window.getBoard()->setAnimationsEnabled(_animate);
+    window.resize(_windowSize);
+    window.show();
+    // The game only starts once the first frame has been painted.
+    QElapsedTimer startup;
+    startup.start();
+    while(!window.isStartupDone() && startup.elapsed() < 5000)
+        flushEvents();
+
+    const auto cells = window.getBoard()->findChildren<Cell*>();
+
+    for (int move = 0; move < _maxMoves; ++move) {
+        auto source = findSource(cells);
+        if(!source)
+            break;
+
+        _counter.paints = 0;
+        _counter.frames = 0;
+        QElapsedTimer timer;
+        timer.start();
+
+        click(source);
+        flushEvents();
+
+        auto destination = findDestination(cells);
+        if(!destination)
+            break;
+        click(destination);
+        flushEvents();
+
+        result.moves.append({ _counter.paints, _counter.frames, timer.nsecsElapsed() });
+    }
+    return result;
+}
+
+QVector<QSize> parseWindowSizes(const QString &_value)
+{
+    QVector<QSize> sizes;
+    for (const auto& item : _value.split(',', QString::SkipEmptyParts)) {
+        const auto parts = item.split('x');
+        if(parts.size() == 2)
+            sizes.append(QSize(parts[0].toInt(), parts[1].toInt()));
+    }
+    return sizes;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("CheckersGuiBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Plays scripted games through the Checkers widgets and checks paint and time budgets.");
+    parser.addHelpOption();
+    QCommandLineOption boardSizesOption("board-sizes", "Comma separated board edge sizes.", "sizes", "8,10");
+    QCommandLineOption windowSizesOption("window-sizes", "Comma separated window sizes.", "sizes", "640x640,1280x800,1920x1080");
+    QCommandLineOption movesOption("moves", "Maximum moves per game.", "count", "80");
+    QCommandLineOption maxPaintsOption("max-paints-per-move", "Fail when a move paints more cells than this.", "count", "64");
+    QCommandLineOption maxFramesOption("max-frames-per-move", "Fail when a move needs more frames than this.", "count", "8");
+    QCommandLineOption maxMsOption("max-ms-per-move", "Fail when the mean wall time per move exceeds this.", "ms", "50");
+    QCommandLineOption animateOption("animate", "Keep move animations enabled; frames are then counted only until the move is applied.");
+    parser.addOptions({ boardSizesOption, windowSizesOption, movesOption, maxPaintsOption, maxFramesOption, maxMsOption, animateOption });
+    parser.process(app);
+
+    const auto maxMoves = parser.value(movesOption).toInt();
+    const auto maxPaints = parser.value(maxPaintsOption).toInt();
+    const auto maxFrames = parser.value(maxFramesOption).toInt();
+    const auto maxMs = parser.value(maxMsOption).toDouble();
+
+    PaintCounter counter;
+    app.installEventFilter(&counter);
+
+    QTextStream out(stdout);
+    out << "board  window      moves  paints/move(max)  frames/move(max)  ms/move(max)\n";
+
+    bool failed = false;
+    for (const auto& sizeText : parser.value(boardSizesOption).split(',', QString::SkipEmptyParts)) {
+        const auto boardSize = sizeText.toInt();
+        if(boardSize < 4 || boardSize > 10 || boardSize % 2 != 0) {
+            out << "skipping unsupported board size " << sizeText << '\n';
+            continue;
+        }
+
+        for (const auto& windowSize : parseWindowSizes(parser.value(windowSizesOption))) {
+            const auto result = playScriptedGame(boardSize, windowSize, maxMoves, parser.isSet(animateOption), counter);
+            if(result.moves.isEmpty()) {
+                out << boardSize << "  no moves were played\n";
+                failed = true;
+                continue;
+            }
+
+            double paints = 0, frames = 0, ms = 0;
+            int worstPaints = 0, worstFrames = 0;
+            double worstMs = 0;
+            for (const auto& sample : result.moves) {
+                paints += sample.paints;
+                frames += sample.frames;
+                ms += sample.nanoseconds / 1e6;
+                worstPaints = std::max(worstPaints, sample.paints);
+                worstFrames = std::max(worstFrames, sample.frames);
+                worstMs = std::max(worstMs, sample.nanoseconds / 1e6);
+            }
+            const auto count = result.moves.size();
+            const auto meanMs = ms / count;
+
+            out << qSetFieldWidth(5) << boardSize << qSetFieldWidth(0) << "  "
+                << QString("%1x%2").arg(windowSize.width()).arg(windowSize.height()).leftJustified(10) << "  "
+                << qSetFieldWidth(5) << count << qSetFieldWidth(0) << "  "
+                << QString("%1 (%2)").arg(paints / count, 0, 'f', 1).arg(worstPaints).leftJustified(16) << "  "
+                << QString("%1 (%2)").arg(frames / count, 0, 'f', 1).arg(worstFrames).leftJustified(16) << "  "
+                << QString("%1 (%2)").arg(meanMs, 0, 'f', 2).arg(worstMs, 0, 'f', 2) << '\n';
+
+            if(worstPaints > maxPaints || worstFrames > maxFrames || meanMs > maxMs) {
+                out << "  budget exceeded\n";
+                failed = true;
+            }
+        }
+    }
+    out.flush();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,384 @@
+#include "engine.hpp"
+#include "metricsendpoint.hpp"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const char *engineName = "Checkers";
+const char *engineVersion = "1.0";
+const int maxHashMegabytes = 4096;
+
+// Lines are queued by whichever thread produces them and written by a thread of their own,
+// so a GUI that is slow to read the pipe never stalls the search or the command loop.
+class Output
+{
+public:
+    Output()
+        : writer([this] { run(); })
+    {}
+
+    ~Output()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        wakeUp.notify_one();
+        writer.join();
+    }
+
+    void post(std::string _line)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lines.push_back(std::move(_line));
+        }
+        wakeUp.notify_one();
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wakeUp.wait(lock, [this] { return closing || !lines.empty(); });
+            if(lines.empty())
+                return;
+
+            std::deque<std::string> batch;
+            batch.swap(lines);
+            lock.unlock();
+            for (const auto& line : batch) {
+                std::fwrite(line.data(), 1, line.size(), stdout);
+                std::fputc('\n', stdout);
+            }
+            std::fflush(stdout);
+            lock.lock();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<std::string> lines;
+    bool closing = false;
+    std::thread writer;
+};
+
+// One protocol line: a command word followed by "key", "key=value" or "key=\"quoted value\"" arguments.
+struct Command
+{
+    std::string name;
+    std::map<std::string, std::string> arguments;
+
+    bool has(const std::string &_key) const { return arguments.count(_key) != 0; }
+    std::string value(const std::string &_key, const std::string &_default = std::string()) const
+    {
+        const auto it = arguments.find(_key);
+        return it == arguments.end() ? _default : it->second;
+    }
+    double number(const std::string &_key, const double _default) const
+    {
+        const auto text = value(_key);
+        return text.empty() ? _default : std::atof(text.c_str());
+    }
+};
+
+Command parseCommand(const std::string &_line)
+{
+    Command command;
+    size_t i = 0;
+    auto skipSpaces = [&] { while(i < _line.size() && std::isspace(static_cast<unsigned char>(_line[i]))) ++i; };
+    auto readUntil = [&](auto _stop) {
+        const auto start = i;
+        while(i < _line.size() && !_stop(_line[i]))
+            ++i;
+        return _line.substr(start, i - start);
+    };
+    auto isSpace = [](char _c) { return std::isspace(static_cast<unsigned char>(_c)) != 0; };
+
+    skipSpaces();
+    command.name = readUntil(isSpace);
+    for (skipSpaces(); i < _line.size(); skipSpaces()) {
+        const auto key = readUntil([&](char _c) { return isSpace(_c) || _c == '='; });
+        std::string value;
+        if(i < _line.size() && _line[i] == '=') {
+            ++i;
+            if(i < _line.size() && _line[i] == '"') {
+                ++i;
+                value = readUntil([](char _c) { return _c == '"'; });
+                ++i;
+            }
+            else {
+                value = readUntil(isSpace);
+            }
+        }
+        command.arguments[key] = value;
+    }
+    return command;
+}
+
+std::string quoted(const std::string &_text)
+{
+    return _text.find(' ') == std::string::npos ? _text : '"' + _text + '"';
+}
+
+class HubEngine
+{
+public:
+    explicit HubEngine(Output &_output)
+        : output(_output)
+        , engine(hashMegabytes)
+        , history(Position::initial(variant))
+    {}
+
+    ~HubEngine()
+    {
+        stopSearch();
+    }
+
+    // Returns false once the session is over.
+    bool handle(const std::string &_line)
+    {
+        const auto command = parseCommand(_line);
+        const auto& name = command.name;
+        if(name.empty())
+            return true;
+
+        if(name == "hub") {
+            output.post(std::string("id name=") + engineName + " version=" + engineVersion);
+            std::string variants;
+            for (auto v : { Variant::Classic, Variant::American, Variant::Russian, Variant::Brazilian, Variant::International, Variant::Pool })
+                variants += std::string(variants.empty() ? "" : " ") + variantInfo(v).name;
+            output.post(std::string("param name=variant value=") + variantInfo(variant).name + " type=enum values=\"" + variants + '"');
+            output.post("param name=hash value=" + std::to_string(hashMegabytes) + " type=int min=1 max=" + std::to_string(maxHashMegabytes));
+            output.post("wait");
+        }
+        else if(name == "set-param") {
+            setParameter(command.value("name"), command.value("value"));
+        }
+        else if(name == "init") {
+            output.post("ready");
+        }
+        else if(name == "ping") {
+            output.post("pong");
+        }
+        else if(name == "new-game") {
+            stopSearch();
+            engine.clearHash();
+            history.reset(Position::initial(variant));
+        }
+        else if(name == "pos") {
+            stopSearch();
+            setPosition(command);
+        }
+        else if(name == "level") {
+            level = command;
+        }
+        else if(name == "go") {
+            stopSearch();
+            startSearch(command.has("ponder") || command.has("analyze"));
+        }
+        else if(name == "ponder-hit") {
+            // The running ponder search becomes the real one; it only needs a deadline now.
+            const auto budget = moveBudgetMs();
+            if(budget > 0)
+                engine.setDeadline(Engine::now() + budget * 1000000);
+            else
+                interruptSearch();
+            releaseResult();
+        }
+        else if(name == "stop") {
+            interruptSearch();
+            releaseResult();
+        }
+        else if(name == "quit") {
+            stopSearch();
+            return false;
+        }
+        else {
+            error("unknown command " + name);
+        }
+        return true;
+    }
+
+private:
+    void error(const std::string &_message)
+    {
+        output.post("error message=\"" + _message + '"');
+    }
+
+    void setParameter(const std::string &_name, const std::string &_value)
+    {
+        stopSearch();
+        if(_name == "variant") {
+            if(variantFromName(_value, variant))
+                history.reset(Position::initial(variant));
+            else
+                error("unknown variant " + _value);
+        }
+        else if(_name == "hash") {
+            hashMegabytes = std::min(std::max(std::atoi(_value.c_str()), 1), maxHashMegabytes);
+            engine.resizeHash(hashMegabytes);
+        }
+        else {
+            error("unknown parameter " + _name);
+        }
+    }
+
+    // A rejected position or move leaves the previous position in place.
+    void setPosition(const Command &_command)
+    {
+        Position start = Position::initial(variant);
+        if(_command.has("pos") && !Position::fromFen(_command.value("pos"), start, variantInfo(variant).edge, variant)) {
+            error("invalid position " + _command.value("pos"));
+            return;
+        }
+
+        GameHistory line(start);
+        std::istringstream moves(_command.value("moves"));
+        std::string text;
+        while(moves >> text) {
+            Position::Move move;
+            if(!line.current().parseMove(text, move)) {
+                error("illegal move " + text);
+                return;
+            }
+            line.play(move);
+        }
+        history = line;
+    }
+
+    // Search time for one move in milliseconds, or 0 when the level sets no time limit.
+    qint64 moveBudgetMs() const
+    {
+        if(level.has("move-time"))
+            return static_cast<qint64>(level.number("move-time", 0) * 1000);
+        if(level.has("time")) {
+            const auto left = level.number("time", 0);
+            const auto increment = level.number("inc", 0);
+            const auto moves = level.number("moves", 30);
+            return static_cast<qint64>(std::max(left / std::max(moves, 1.0) + increment * 0.8, 0.01) * 1000);
+        }
+        return 0;
+    }
+
+    void startSearch(const bool _infinite)
+    {
+        Engine::Limits limits;
+        if(!_infinite && !level.has("infinite")) {
+            limits.depth = static_cast<int>(level.number("depth", Engine::maxDepth));
+            limits.nodes = static_cast<quint64>(level.number("nodes", 0));
+            limits.timeMs = moveBudgetMs();
+        }
+        limits.cancelled = &cancelled;
+        holdResult = _infinite;
+        cancelled.store(false);
+        engine.setDeadline(Engine::noDeadline);
+
+        const auto root = history;
+        searcher = std::thread([this, root, limits] {
+            const auto start = Engine::now();
+            const auto& position = root.current();
+            const auto result = engine.search(position, limits, [&](const Engine::Result &_info) {
+                const auto elapsed = std::max<qint64>(Engine::now() - start, 1);
+                std::string pv;
+                auto line = position;
+                for (const auto& move : _info.pv) {
+                    pv += (pv.empty() ? "" : " ") + line.moveToString(move);
+                    line = line.play(move);
+                }
+                output.post("info depth=" + std::to_string(_info.depth) + " score=" + std::to_string(_info.score)
+                            + " nodes=" + std::to_string(_info.nodes) + " time=" + std::to_string(elapsed / 1e9)
+                            + " nps=" + std::to_string(static_cast<quint64>(_info.nodes * 1e9 / elapsed))
+                            + " pv=" + quoted(pv));
+            }, &root);
+
+            // A ponder or analysis search only reports once it is stopped or turned into a real search.
+            {
+                std::unique_lock<std::mutex> lock(resultMutex);
+                resultReleased.wait(lock, [this] { return !holdResult; });
+            }
+
+            std::string done = "done";
+            if(result.hasMove) {
+                done += " move=" + position.moveToString(result.move);
+                if(result.pv.size() > 1)
+                    done += " ponder=" + position.play(result.move).moveToString(result.pv[1]);
+            }
+            output.post(done);
+        });
+    }
+
+    void releaseResult()
+    {
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            holdResult = false;
+        }
+        resultReleased.notify_one();
+    }
+
+    // search() clears its own stop flag and replaces the deadline of a timed search when it
+    // begins, so the hub stops through a flag of its own that outlives a search not yet started.
+    void interruptSearch()
+    {
+        cancelled.store(true);
+    }
+
+    void stopSearch()
+    {
+        if(!searcher.joinable())
+            return;
+        interruptSearch();
+        releaseResult();
+        searcher.join();
+    }
+
+private:
+    Output &output;
+    int hashMegabytes = Engine::defaultHashMegabytes;
+    Variant variant = Variant::Classic;
+    Engine engine;
+    GameHistory history;
+    Command level;
+    std::thread searcher;
+    std::atomic<bool> cancelled { false };
+    std::mutex resultMutex;
+    std::condition_variable resultReleased;
+    bool holdResult = false;
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CheckersHub");
+    MetricsThread metrics;
+
+    // The command loop owns stdin; searches run on their own thread and output has a writer thread.
+    Output output;
+    HubEngine hub(output);
+    std::string line;
+    while(std::getline(std::cin, line)) {
+        if(!hub.handle(line))
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "inputlog.hpp"
+
+namespace {
+
+const quint32 magic = 0x434b494c; // "CKIL"
+const quint16 version = 1;
+
+bool isPointer(const InputEvent::Kind _kind)
+{
+    return _kind == InputEvent::Kind::MousePress || _kind == InputEvent::Kind::MouseRelease
+            || _kind == InputEvent::Kind::MouseDoubleClick;
+}
+
+bool isKey(const InputEvent::Kind _kind)
+{
+    return _kind == InputEvent::Kind::KeyPress || _kind == InputEvent::Kind::KeyRelease;
+}
+
+}
+
+bool InputLogWriter::open(const QString &_fileName, const InputLogHeader &_header)
+{
+    file.setFileName(_fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    stream.setDevice(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << magic << version << quint8(_header.variant) << quint8(_header.edge) << qint8(_header.engineSide);
+    lastTimeUs = 0;
+    return stream.status() == QDataStream::Ok;
+}
+
+void InputLogWriter::append(const InputEvent &_event)
+{
+    if(!file.isOpen())
+        return;
+
+    const auto delta = qMax<qint64>(_event.timeUs - lastTimeUs, 0);
+    lastTimeUs += delta;
+    stream << quint8(_event.kind) << quint32(qMin<qint64>(delta, 0xFFFFFFFF));
+
+    if(isPointer(_event.kind) || isKey(_event.kind))
+        stream << quint8(_event.target) << _event.x << _event.y << _event.modifiers;
+    if(isPointer(_event.kind))
+        stream << _event.button << _event.buttons;
+    else if(isKey(_event.kind))
+        stream << _event.key << _event.text;
+    else if(_event.kind == InputEvent::Kind::Resize)
+        stream << _event.x << _event.y;
+    else if(_event.kind == InputEvent::Kind::EndOfMove)
+        stream << _event.hash;
+    else if(_event.kind == InputEvent::Kind::EngineMove) {
+        const auto& move = _event.move;
+        stream << move.from << move.to << move.length << move.captured;
+        for (int i = 0; i < move.length; ++i)
+            stream << move.path[i];
+    }
+}
+
+void InputLogWriter::flush()
+{
+    file.flush();
+}
+
+bool InputLog::read(const QString &_fileName, InputLogHeader &_header, std::vector<InputEvent> &_events, QString *_error)
+{
+    auto fail = [&](const QString &_message) {
+        if(_error)
+            *_error = _message;
+        return false;
+    };
+
+    QFile file(_fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        return fail(QString("cannot open %1").arg(_fileName));
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 fileMagic = 0;
+    quint16 fileVersion = 0;
+    quint8 variant = 0;
+    quint8 edge = 0;
+    qint8 engineSide = -1;
+    stream >> fileMagic >> fileVersion >> variant >> edge >> engineSide;
+    if(fileMagic != magic || fileVersion != version)
+        return fail("not an input log of this version");
+    if(variant > quint8(Variant::Pool) || (edge != 8 && edge != 10))
+        return fail("corrupt header");
+    _header.variant = Variant(variant);
+    _header.edge = edge;
+    _header.engineSide = engineSide;
+
+    _events.clear();
+    qint64 timeUs = 0;
+    while(!stream.atEnd()) {
+        InputEvent event;
+        quint8 kind = 0;
+        quint32 delta = 0;
+        stream >> kind >> delta;
+        if(kind > quint8(InputEvent::Kind::EndOfMove))
+            return fail(QString("corrupt record %1").arg(_events.size()));
+        event.kind = InputEvent::Kind(kind);
+        timeUs += delta;
+        event.timeUs = timeUs;
+
+        if(isPointer(event.kind) || isKey(event.kind)) {
+            quint8 target = 0;
+            stream >> target >> event.x >> event.y >> event.modifiers;
+            event.target = InputEvent::Target(target);
+        }
+        if(isPointer(event.kind))
+            stream >> event.button >> event.buttons;
+        else if(isKey(event.kind))
+            stream >> event.key >> event.text;
+        else if(event.kind == InputEvent::Kind::Resize)
+            stream >> event.x >> event.y;
+        else if(event.kind == InputEvent::Kind::EndOfMove)
+            stream >> event.hash;
+        else if(event.kind == InputEvent::Kind::EngineMove) {
+            auto& move = event.move;
+            stream >> move.from >> move.to >> move.length >> move.captured;
+            if(move.length > Position::maxPath)
+                return fail(QString("corrupt record %1").arg(_events.size()));
+            for (int i = 0; i < move.length; ++i)
+                stream >> move.path[i];
+        }
+
+        // A log cut short by a crash still replays up to its last complete record.
+        if(stream.status() != QDataStream::Ok)
+            break;
+        _events.push_back(event);
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "position.hpp"
+
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+
+#include <vector>
+
+// One recorded input: a mouse event on a board square, a key event on a square or the focus
+// widget of the window, a window resize, a move delivered by the engine, or the end of a move
+// on the board.
+struct InputEvent
+{
+    enum class Kind : quint8 { MousePress, MouseRelease, MouseDoubleClick, KeyPress, KeyRelease, Resize, EngineMove, EndOfMove };
+    enum class Target : quint8 { Cell, Board, Window };
+
+    Kind kind = Kind::MousePress;
+    qint64 timeUs = 0;
+    Target target = Target::Cell;
+    // Cell row and column, a position inside the board widget, or the new window size.
+    qint16 x = 0;
+    qint16 y = 0;
+    quint8 button = 0;
+    quint32 buttons = 0;
+    quint32 modifiers = 0;
+    qint32 key = 0;
+    QString text;
+    // EndOfMove: hash of the board with White to move, to detect a replay that diverged.
+    quint64 hash = 0;
+    Position::Move move;
+};
+
+struct InputLogHeader
+{
+    Variant variant = Variant::Classic;
+    int edge = 8;
+    // -1 without an engine, otherwise the Checker::Type the engine played.
+    int engineSide = -1;
+};
+
+// Compact binary log: a header, then one record per event holding its kind, the microseconds
+// since the previous record and only the fields that kind uses.
+class InputLog
+{
+public:
+    static bool read(const QString &_fileName, InputLogHeader &_header, std::vector<InputEvent> &_events, QString *_error = nullptr);
+};
+
+class InputLogWriter
+{
+public:
+    bool open(const QString &_fileName, const InputLogHeader &_header);
+    void append(const InputEvent &_event);
+    void flush();
+
+private:
+    QFile file;
+    QDataStream stream;
+    qint64 lastTimeUs = 0;
+};
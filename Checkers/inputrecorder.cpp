@@ -0,0 +1,125 @@
+#include "inputrecorder.hpp"
+#include "mainwindow.hpp"
+
+#include <QApplication>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QResizeEvent>
+
+InputRecorder::InputRecorder(MainWindow *_window, int _engineSide)
+    : QObject(_window)
+    , window(_window)
+{
+    header.variant = window->getBoard()->variant();
+    header.edge = window->getBoard()->getBoardSize();
+    header.engineSide = _engineSide;
+}
+
+bool InputRecorder::open(const QString &_fileName)
+{
+    if(!writer.open(_fileName, header))
+        return false;
+
+    clock.start();
+    qApp->installEventFilter(this);
+    connect(window, &MainWindow::engineMoveReady, this, &InputRecorder::onEngineMove);
+    connect(window->getBoard(), &BoardWidget::endOfMove, this, &InputRecorder::onEndOfMove);
+    return true;
+}
+
+// Events a Cell ignores propagate to the Checkerboard, so only the Cell delivery is recorded;
+// the low-memory board has no Cells and takes its input directly.
+bool InputRecorder::locate(QObject *_watched, const QPoint &_pos, InputEvent &_event) const
+{
+#ifdef CHECKERS_LOW_MEMORY
+    if(_watched == window->getBoard()) {
+        _event.target = InputEvent::Target::Board;
+        _event.x = static_cast<qint16>(_pos.x());
+        _event.y = static_cast<qint16>(_pos.y());
+        return true;
+    }
+#else
+    Q_UNUSED(_pos);
+    if(auto cell = qobject_cast<Cell*>(_watched)) {
+        _event.target = InputEvent::Target::Cell;
+        _event.x = static_cast<qint16>(cell->getIndex().first);
+        _event.y = static_cast<qint16>(cell->getIndex().second);
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool InputRecorder::eventFilter(QObject *_watched, QEvent *_event)
+{
+    InputEvent event;
+    switch (_event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick: {
+        const auto mouse = static_cast<QMouseEvent*>(_event);
+        if(!locate(_watched, mouse->pos(), event))
+            break;
+        event.kind = _event->type() == QEvent::MouseButtonPress ? InputEvent::Kind::MousePress
+                : (_event->type() == QEvent::MouseButtonRelease ? InputEvent::Kind::MouseRelease : InputEvent::Kind::MouseDoubleClick);
+        event.button = static_cast<quint8>(mouse->button());
+        event.buttons = static_cast<quint32>(mouse->buttons());
+        event.modifiers = static_cast<quint32>(mouse->modifiers());
+        append(event);
+        break;
+    }
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease: {
+        // Key events go to the focus widget, or the window without one, and then to the parents
+        // that ignore them; only that first delivery is recorded.
+        const auto focus = window->focusWidget();
+        if(_watched != (focus ? focus : static_cast<QWidget*>(window)))
+            break;
+        if(!locate(_watched, QPoint(), event))
+            event.target = InputEvent::Target::Window;
+        const auto key = static_cast<QKeyEvent*>(_event);
+        event.kind = _event->type() == QEvent::KeyPress ? InputEvent::Kind::KeyPress : InputEvent::Kind::KeyRelease;
+        event.key = key->key();
+        event.modifiers = static_cast<quint32>(key->modifiers());
+        event.text = key->text();
+        append(event);
+        break;
+    }
+    case QEvent::Resize:
+        if(_watched == window) {
+            const auto size = static_cast<QResizeEvent*>(_event)->size();
+            event.kind = InputEvent::Kind::Resize;
+            event.x = static_cast<qint16>(size.width());
+            event.y = static_cast<qint16>(size.height());
+            append(event);
+        }
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+void InputRecorder::onEngineMove(const Position::Move &_move)
+{
+    InputEvent event;
+    event.kind = InputEvent::Kind::EngineMove;
+    event.move = _move;
+    append(event);
+}
+
+void InputRecorder::onEndOfMove()
+{
+    InputEvent event;
+    event.kind = InputEvent::Kind::EndOfMove;
+    event.hash = window->getBoard()->toPosition(Checker::Type::White).hash();
+    append(event);
+    // Moves are rare enough to flush on, so a log from a kiosk that crashed is still usable.
+    writer.flush();
+}
+
+void InputRecorder::append(InputEvent &_event)
+{
+    _event.timeUs = clock.nsecsElapsed() / 1000;
+    writer.append(_event);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "inputlog.hpp"
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class MainWindow;
+
+// Records what drives one MainWindow into an input log: mouse events on the board squares, key
+// events where the window delivers them, window resizes, engine moves and the end of every move,
+// each with its timestamp. Keys consumed as shortcuts never reach a widget and are not recorded.
+class InputRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    InputRecorder(MainWindow *_window, int _engineSide);
+
+    bool open(const QString &_fileName);
+
+protected:
+    bool eventFilter(QObject *_watched, QEvent *_event) override;
+
+private slots:
+    void onEngineMove(const Position::Move &_move);
+    void onEndOfMove();
+
+private:
+    bool locate(QObject *_watched, const QPoint &_pos, InputEvent &_event) const;
+    void append(InputEvent &_event);
+
+private:
+    MainWindow *window;
+    InputLogHeader header;
+    InputLogWriter writer;
+    QElapsedTimer clock;
+};
@@ -0,0 +1,319 @@
+#include "mainwindow.hpp"
+#include "inputlog.hpp"
+#include "inputrecorder.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QKeyEvent>
+#include <QMap>
+#include <QMouseEvent>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+bool waitFor(const std::function<bool()> &_condition, const int _timeoutMs)
+{
+    QEventLoop loop;
+    QTimer deadline;
+    deadline.setSingleShot(true);
+    deadline.start(_timeoutMs);
+    while(!_condition() && deadline.isActive())
+        loop.processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents, 10);
+    return _condition();
+}
+
+void sleepUntil(const QElapsedTimer &_clock, const qint64 _timeUs)
+{
+    const auto remainingMs = (_timeUs - _clock.nsecsElapsed() / 1000) / 1000;
+    if(remainingMs > 0) {
+        QEventLoop loop;
+        QTimer::singleShot(static_cast<int>(remainingMs), Qt::PreciseTimer, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    QApplication::processEvents();
+}
+
+// Synthetic presses skip the click-to-focus Qt applies to real ones, and recorded keys without
+// a square go to the focus widget, so the focus moves here as it did while recording.
+void giveClickFocus(QWidget *_widget)
+{
+    for (auto widget = _widget; widget; widget = widget->parentWidget()) {
+        if(widget->focusPolicy() & Qt::ClickFocus) {
+            widget->setFocus(Qt::MouseFocusReason);
+            return;
+        }
+        if(widget->isWindow())
+            return;
+    }
+}
+
+// Sends recorded pointer and key events to the widget that received them originally.
+class InputPlayer
+{
+public:
+    explicit InputPlayer(MainWindow *_window)
+        : window(_window)
+        , board(_window->getBoard())
+    {
+#ifndef CHECKERS_LOW_MEMORY
+        for (auto cell : board->findChildren<Cell*>())
+            cells.insert(cell->getIndex(), cell);
+#endif
+    }
+
+    bool deliver(const InputEvent &_event)
+    {
+        QWidget *receiver = nullptr;
+        QPoint pos;
+        if(_event.target == InputEvent::Target::Window) {
+            receiver = window->focusWidget() ? window->focusWidget() : window;
+        }
+        else if(_event.target == InputEvent::Target::Board) {
+            receiver = board;
+            pos = QPoint(_event.x, _event.y);
+        }
+#ifndef CHECKERS_LOW_MEMORY
+        else if(_event.target == InputEvent::Target::Cell) {
+            receiver = cells.value(Checker::index_t(_event.x, _event.y));
+            if(receiver)
+                pos = receiver->rect().center();
+        }
+#endif
+        if(!receiver)
+            return false;
+
+        const auto modifiers = Qt::KeyboardModifiers(_event.modifiers);
+        switch (_event.kind) {
+        case InputEvent::Kind::MousePress:
+        case InputEvent::Kind::MouseRelease:
+        case InputEvent::Kind::MouseDoubleClick: {
+            const auto type = _event.kind == InputEvent::Kind::MousePress ? QEvent::MouseButtonPress
+                    : (_event.kind == InputEvent::Kind::MouseRelease ? QEvent::MouseButtonRelease : QEvent::MouseButtonDblClick);
+            QMouseEvent mouse(type, pos, receiver->mapToGlobal(pos), Qt::MouseButton(_event.button),
+                              Qt::MouseButtons(_event.buttons), modifiers);
+            if(type == QEvent::MouseButtonPress)
+                giveClickFocus(receiver);
+            QApplication::sendEvent(receiver, &mouse);
+            return true;
+        }
+        case InputEvent::Kind::KeyPress:
+        case InputEvent::Kind::KeyRelease: {
+            QKeyEvent key(_event.kind == InputEvent::Kind::KeyPress ? QEvent::KeyPress : QEvent::KeyRelease,
+                          _event.key, modifiers, _event.text);
+            QApplication::sendEvent(receiver, &key);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+private:
+    MainWindow *window;
+    BoardWidget *board;
+#ifndef CHECKERS_LOW_MEMORY
+    QMap<Checker::index_t, Cell*> cells;
+#endif
+};
+
+// Replays _fileName against a fresh main window: 0 when every move reaches the recorded
+// position, 1 on a divergence and 2 when the log or the window cannot be set up.
+int replay(const QString &_fileName, const bool _fast, const int _moveTimeoutMs, QTextStream &_out)
+{
+    InputLogHeader header;
+    std::vector<InputEvent> events;
+    QString error;
+    if(!InputLog::read(_fileName, header, events, &error)) {
+        _out << error << '\n';
+        return 2;
+    }
+
+    // Engine moves come from the log, so the replay does not depend on search timing.
+    MainWindow window(header.edge, header.variant);
+    if(header.engineSide >= 0)
+        window.setExternalEngine(Checker::Type(header.engineSide));
+    auto board = window.getBoard();
+    int boardMoves = 0;
+    QObject::connect(board, &BoardWidget::endOfMove, &window, [&boardMoves] { ++boardMoves; });
+
+    QElapsedTimer clock;
+    clock.start();
+    window.show();
+    if(!waitFor([&] { return window.isStartupDone(); }, 10000)) {
+        _out << "startup did not finish\n";
+        return 2;
+    }
+
+    InputPlayer player(&window);
+    int expectedMoves = 0;
+    int divergences = 0;
+    int skipped = 0;
+    qint64 maxLagUs = 0;
+
+    for (const auto& event : events) {
+        if(_fast)
+            QApplication::processEvents();
+        else
+            sleepUntil(clock, event.timeUs);
+        maxLagUs = qMax(maxLagUs, clock.nsecsElapsed() / 1000 - event.timeUs);
+
+        switch (event.kind) {
+        case InputEvent::Kind::Resize:
+            window.resize(event.x, event.y);
+            break;
+        case InputEvent::Kind::EngineMove:
+            board->playMove(event.move);
+            break;
+        case InputEvent::Kind::EndOfMove:
+            // Later input only makes sense once the board has finished the same move.
+            ++expectedMoves;
+            if(!waitFor([&] { return boardMoves >= expectedMoves; }, _moveTimeoutMs)) {
+                _out << "move " << expectedMoves << " did not finish\n";
+                ++divergences;
+            }
+            else if(board->toPosition(Checker::Type::White).hash() != event.hash) {
+                _out << "move " << expectedMoves << " reached a different position: "
+                     << QString::fromStdString(board->toPosition(Checker::Type::White).toFen()) << '\n';
+                ++divergences;
+            }
+            break;
+        default:
+            if(!player.deliver(event))
+                ++skipped;
+            break;
+        }
+    }
+    waitFor([] { return false; }, 100);
+
+    const auto recordedMs = events.empty() ? 0 : events.back().timeUs / 1000;
+    _out << events.size() << " events, " << expectedMoves << " moves, " << skipped << " skipped, "
+         << divergences << " divergences\n"
+         << "recorded " << recordedMs << " ms, replayed " << clock.elapsed() << " ms";
+    if(!_fast)
+        _out << ", max lag " << maxLagUs / 1000.0 << " ms";
+    _out << '\n';
+    return divergences == 0 ? 0 : 1;
+}
+
+#ifndef CHECKERS_LOW_MEMORY
+Cell *findCell(const QList<Cell*> &_cells, const std::function<bool(const Cell*)> &_predicate)
+{
+    const auto it = std::find_if(_cells.cbegin(), _cells.cend(), _predicate);
+    return it == _cells.cend() ? nullptr : *it;
+}
+
+void click(Cell *_cell)
+{
+    const QPoint center = _cell->rect().center();
+    QMouseEvent press(QEvent::MouseButtonPress, center, _cell->mapToGlobal(center), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QApplication::sendEvent(_cell, &press);
+}
+#endif
+
+// Records a game in which White moves by clicking two squares and the engine answers as Black,
+// then replays the log; the recording and the replay have to reach the same positions.
+int roundTrip(const int _moveTimeoutMs, QTextStream &_out)
+{
+#ifdef CHECKERS_LOW_MEMORY
+    Q_UNUSED(_moveTimeoutMs);
+    _out << "the round trip clicks board squares, which the low-memory board does not have\n";
+    return 2;
+#else
+    QTemporaryFile log;
+    if(!log.open()) {
+        _out << "unable to create a temporary input log\n";
+        return 2;
+    }
+
+    {
+        MainWindow window;
+        window.enableEngine(Checker::Type::Black, 50, false);
+        auto recorder = new InputRecorder(&window, static_cast<int>(Checker::Type::Black));
+        if(!recorder->open(log.fileName())) {
+            _out << "unable to record to " << log.fileName() << '\n';
+            return 2;
+        }
+        int boardMoves = 0;
+        QObject::connect(window.getBoard(), &BoardWidget::endOfMove, &window, [&boardMoves] { ++boardMoves; });
+
+        window.show();
+        if(!waitFor([&] { return window.isStartupDone(); }, 10000)) {
+            _out << "startup did not finish\n";
+            return 2;
+        }
+
+        const auto cells = window.getBoard()->findChildren<Cell*>();
+        auto source = findCell(cells, [](const Cell *_cell) {
+            return _cell->isActivated() && _cell->hasChecker() && !_cell->isOpenForJump() && !_cell->isOpenForMove();
+        });
+        if(source)
+            click(source);
+        auto destination = findCell(cells, [](const Cell *_cell) { return _cell->isOpenForMove() || _cell->isOpenForJump(); });
+        if(!source || !destination) {
+            _out << "no move for White\n";
+            return 2;
+        }
+        click(destination);
+        if(!waitFor([&] { return boardMoves >= 2; }, _moveTimeoutMs)) {
+            _out << "the engine did not answer\n";
+            return 2;
+        }
+    }
+    return replay(log.fileName(), true, _moveTimeoutMs, _out);
+#endif
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("CheckersInputReplay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays an input log recorded with Checkers --record against a headless main window.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("log", "Input log to replay.");
+    QCommandLineOption fastOption("fast", "Replay as fast as possible instead of with the recorded timing.");
+    QCommandLineOption roundTripOption("round-trip", "Record a short game against the engine, then replay it with --fast.");
+    QCommandLineOption traceOption("trace", "Write a Chrome trace of the replay.", "file");
+    QCommandLineOption metricsOption("metrics", "Write the metrics collected during the replay in Prometheus text format.", "file");
+    QCommandLineOption moveTimeoutOption("move-timeout", "How long to wait for a recorded move to finish.", "ms", "5000");
+    parser.addOptions({ fastOption, roundTripOption, traceOption, metricsOption, moveTimeoutOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    Trace::setEnabled(parser.isSet(traceOption));
+    const auto moveTimeout = parser.value(moveTimeoutOption).toInt();
+    int result = 2;
+    if(parser.isSet(roundTripOption))
+        result = roundTrip(moveTimeout, out);
+    else if(parser.positionalArguments().size() == 1)
+        result = replay(parser.positionalArguments().first(), parser.isSet(fastOption), moveTimeout, out);
+    else
+        out << "usage: CheckersInputReplay [options] <log>\n";
+
+    if(parser.isSet(traceOption) && !Trace::exportChromeJson(parser.value(traceOption)))
+        out << "unable to write " << parser.value(traceOption) << '\n';
+    if(parser.isSet(metricsOption)) {
+        QFile file(parser.value(metricsOption));
+        if(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            file.write(Metrics::prometheusText());
+        else
+            out << "unable to write " << parser.value(metricsOption) << '\n';
+    }
+    return result;
+}
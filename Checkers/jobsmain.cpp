@@ -0,0 +1,393 @@
+#include "workqueue.hpp"
+#include "engine.hpp"
+#include "pnsolver.hpp"
+#include "metricsendpoint.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostInfo>
+#include <QJsonArray>
+#include <QMap>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Checkpoint = std::function<void(const QJsonObject&)>;
+
+quint64 perft(const Position &_position, int _depth)
+{
+    if(_depth == 0)
+        return 1;
+    Position::MoveList moves;
+    _position.generateMoves(moves);
+    if(_depth == 1)
+        return moves.size();
+
+    quint64 nodes = 0;
+    for (const auto& move : moves)
+        nodes += perft(_position.play(move), _depth - 1);
+    return nodes;
+}
+
+bool readPosition(const QJsonObject &_parameters, Position &_position)
+{
+    Variant variant = Variant::Classic;
+    if(!variantFromName(_parameters.value("variant").toString("classic").toStdString(), variant))
+        return false;
+    return Position::fromFen(_parameters.value("fen").toString().toStdString(), _position,
+                             _parameters.value("edge").toInt(8), variant);
+}
+
+bool runPerft(const WorkQueue::Unit &_unit, QJsonObject &_result)
+{
+    Position position;
+    if(!readPosition(_unit.parameters, position))
+        return false;
+    _result.insert("nodes", QString::number(perft(position, _unit.parameters.value("depth").toInt())));
+    return true;
+}
+
+bool runSolve(const WorkQueue::Unit &_unit, QJsonObject &_result)
+{
+    Position position;
+    if(!readPosition(_unit.parameters, position))
+        return false;
+
+    PnSolver::Limits limits;
+    limits.nodes = static_cast<quint64>(_unit.parameters.value("nodes").toDouble(1e7));
+    limits.maxPlies = _unit.parameters.value("maxPlies").toInt(80);
+    PnSolver solver(limits);
+    const auto result = solver.solve(position);
+
+    _result.insert("outcome", PnSolver::outcomeName(result.outcome));
+    if(result.hasMove)
+        _result.insert("move", QString::fromStdString(position.moveToString(result.bestMove)));
+    _result.insert("nodes", QString::number(result.nodes));
+    return true;
+}
+
+bool runSelfPlay(const WorkQueue::Unit &_unit, const QJsonObject &_checkpoint, const Checkpoint &_save, QJsonObject &_result)
+{
+    // Games are the resumable step: the checkpoint holds every finished game of this unit.
+    const auto games = _unit.parameters.value("games").toInt(1);
+    const auto moveTime = _unit.parameters.value("moveTime").toInt(100);
+    const auto maxPlies = _unit.parameters.value("maxPlies").toInt(200);
+    const auto edge = _unit.parameters.value("edge").toInt(8);
+    auto finished = _checkpoint.value("games").toArray();
+
+    Engine engine(_unit.parameters.value("hash").toInt(Engine::defaultHashMegabytes));
+    Engine::Limits limits;
+    limits.timeMs = moveTime;
+
+    while(finished.size() < games) {
+        // Repetitions and the quiet-move limit end games long before maxPlies in drawn endings.
+        GameHistory history(Position::initial(edge));
+        auto outcome = history.outcome();
+        while(outcome == GameHistory::Outcome::Ongoing && history.plies() < maxPlies) {
+            const auto search = engine.search(history.current(), limits, Engine::InfoCallback(), &history);
+            history.play(search.move);
+            outcome = history.outcome();
+        }
+        const QString result = outcome == GameHistory::Outcome::Ongoing ? "unfinished" : GameHistory::outcomeName(outcome);
+        finished.append(QJsonObject { { "result", result }, { "plies", history.plies() } });
+        _save(QJsonObject { { "games", finished } });
+    }
+
+    _result.insert("games", finished);
+    return true;
+}
+
+// Renews a unit's lease from a thread of its own while the unit runs, so perft and solve units,
+// which have no checkpoints, are not requeued and computed twice when they outlast the lease.
+class LeaseKeeper
+{
+public:
+    LeaseKeeper(WorkQueue &_queue, const WorkQueue::Unit &_unit, const int _leaseSeconds)
+        : queue(_queue)
+        , unit(_unit)
+        , interval(std::max(_leaseSeconds / 3, 1))
+        , keeper([this] { run(); })
+    {}
+
+    ~LeaseKeeper()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        wakeUp.notify_one();
+        keeper.join();
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(!wakeUp.wait_for(lock, interval, [this] { return finished; }))
+            queue.heartbeat(unit);
+    }
+
+private:
+    WorkQueue &queue;
+    const WorkQueue::Unit unit;
+    const std::chrono::seconds interval;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool finished = false;
+    std::thread keeper;
+};
+
+int split(const QStringList &_args, WorkQueue &_queue, QTextStream &_out)
+{
+    const auto kind = _args.value(0);
+    int submitted = 0;
+
+    if(kind == "perft") {
+        // perft <fen|initial> <depth> [variant]: one unit per root move.
+        const auto variantName = _args.value(3, "classic");
+        Variant variant = Variant::Classic;
+        Position root;
+        const auto depth = _args.value(2).toInt();
+        bool parsed = variantFromName(variantName.toStdString(), variant);
+        if(parsed && _args.value(1) == "initial")
+            root = Position::initial(variant);
+        else if(parsed)
+            parsed = Position::fromFen(_args.value(1).toStdString(), root, 8, variant);
+        if(!parsed || depth < 1) {
+            _out << "usage: split perft <fen|initial> <depth> [variant]\n";
+            return 1;
+        }
+        Position::MoveList moves;
+        root.generateMoves(moves);
+        for (const auto& move : moves) {
+            WorkQueue::Unit unit;
+            unit.kind = "perft";
+            unit.id = QString("perft-%1").arg(QString::fromStdString(root.moveToString(move))).replace('x', '_');
+            unit.parameters = QJsonObject { { "fen", QString::fromStdString(root.play(move).toFen()) }, { "depth", depth - 1 },
+                                            { "variant", variantName } };
+            submitted += _queue.submit(unit);
+        }
+    }
+    else if(kind == "solve") {
+        for (int i = 1; i < _args.size(); ++i) {
+            WorkQueue::Unit unit;
+            unit.kind = "solve";
+            unit.id = QString("solve-%1").arg(i, 6, 10, QChar('0'));
+            unit.parameters = QJsonObject { { "fen", _args[i] } };
+            submitted += _queue.submit(unit);
+        }
+    }
+    else if(kind == "selfplay") {
+        // selfplay <games> <gamesPerUnit> [moveTimeMs]
+        const auto games = _args.value(1).toInt();
+        const auto perUnit = qMax(1, _args.value(2).toInt());
+        const auto moveTime = _args.size() > 3 ? _args[3].toInt() : 100;
+        for (int first = 0; first < games; first += perUnit) {
+            WorkQueue::Unit unit;
+            unit.kind = "selfplay";
+            unit.id = QString("selfplay-%1").arg(first, 6, 10, QChar('0'));
+            unit.parameters = QJsonObject { { "games", qMin(perUnit, games - first) }, { "moveTime", moveTime } };
+            submitted += _queue.submit(unit);
+        }
+    }
+    else {
+        _out << "unknown job kind " << kind << '\n';
+        return 1;
+    }
+
+    _out << "submitted " << submitted << " units\n";
+    return 0;
+}
+
+// perft <variant> <depth>: counts the initial position in this process, without a queue,
+// so the published node counts of each variant can be checked.
+int localPerft(const QStringList &_args, QTextStream &_out)
+{
+    Variant variant = Variant::Classic;
+    const auto depth = _args.value(1).toInt();
+    if(!variantFromName(_args.value(0).toStdString(), variant) || depth < 1) {
+        _out << "usage: perft <variant> <depth>\n";
+        return 1;
+    }
+    _out << "perft nodes " << perft(Position::initial(variant), depth) << '\n';
+    return 0;
+}
+
+// Plays _moves on _history, one move text per word; false when a move is not legal.
+bool playLine(GameHistory &_history, const QString &_moves)
+{
+    for (const auto& text : _moves.split(' ', QString::SkipEmptyParts)) {
+        Position::Move move;
+        if(!_history.current().parseMove(text.toStdString(), move))
+            return false;
+        _history.play(move);
+    }
+    return true;
+}
+
+bool expectOutcome(const char *_name, const GameHistory &_history, const GameHistory::Outcome _expected, QTextStream &_out)
+{
+    const auto outcome = _history.outcome();
+    if(outcome == _expected)
+        return true;
+    _out << _name << ": expected " << GameHistory::outcomeName(_expected) << " after " << _history.plies()
+         << " plies, got " << GameHistory::outcomeName(outcome) << '\n';
+    return false;
+}
+
+// rules: plays known lines through GameHistory, so the draw rules and the end of a game are
+// checked next to the move generator.
+int rules(QTextStream &_out)
+{
+    Position start;
+    bool ok = true;
+
+    // Two kings shuffling back and forth; the start position occurs for the third time at ply 8.
+    Position::fromFen("W:WK5:BK28", start, 8, Variant::American);
+    GameHistory repetition(start);
+    ok &= playLine(repetition, "5-9 28-24 9-5 24-28 5-9 28-24 9-5");
+    ok &= expectOutcome("repetition", repetition, GameHistory::Outcome::Ongoing, _out);
+    ok &= playLine(repetition, "24-28");
+    ok &= expectOutcome("repetition", repetition, GameHistory::Outcome::Repetition, _out);
+
+    // Kings that never return to an earlier position and never offer a capture run into the
+    // quiet-move limit; the first such move of the generator is taken each ply.
+    Position::fromFen("W:WK1,K5:BK28,K32", start, 8, Variant::American);
+    GameHistory quiet(start);
+    while(ok && quiet.outcome() == GameHistory::Outcome::Ongoing) {
+        Position::MoveList moves;
+        quiet.current().generateMoves(moves);
+        const auto fresh = std::find_if(moves.begin(), moves.end(), [&](const Position::Move &_move) {
+            const auto next = quiet.current().play(_move);
+            Position::MoveList replies;
+            next.generateMoves(replies);
+            const auto& seen = quiet.reversibleHashes();
+            return (replies.empty() || !replies[0].isCapture()) && std::find(seen.begin(), seen.end(), next.hash()) == seen.end();
+        });
+        ok &= fresh != moves.end();
+        if(ok)
+            quiet.play(*fresh);
+    }
+    ok &= expectOutcome("move limit", quiet, GameHistory::Outcome::MoveLimit, _out);
+    ok &= quiet.plies() == quiet.quietPlyLimit();
+
+    // Capturing the last black piece leaves Black without moves.
+    Position::fromFen("W:W18:B14", start, 8, Variant::American);
+    GameHistory loss(start);
+    ok &= playLine(loss, "18x9");
+    ok &= expectOutcome("no moves", loss, GameHistory::Outcome::WhiteWins, _out);
+
+    _out << (ok ? "rules ok\n" : "rules failed\n");
+    return ok ? 0 : 1;
+}
+
+int work(WorkQueue &_queue, const QString &_worker, const int _lease, QTextStream &_out)
+{
+    int processed = 0;
+    _queue.requeueExpired(_lease);
+
+    WorkQueue::Unit unit;
+    while(_queue.claim(_worker, unit)) {
+        const auto checkpoint = _queue.loadCheckpoint(unit);
+        const Checkpoint save = [&](const QJsonObject &_state) { _queue.saveCheckpoint(unit, _state); };
+
+        QJsonObject result;
+        bool ok = false;
+        {
+            LeaseKeeper lease(_queue, unit, _lease);
+            if(unit.kind == "perft")
+                ok = runPerft(unit, result);
+            else if(unit.kind == "solve")
+                ok = runSolve(unit, result);
+            else if(unit.kind == "selfplay")
+                ok = runSelfPlay(unit, checkpoint, save, result);
+        }
+
+        const bool recorded = ok ? _queue.complete(unit, result) : _queue.fail(unit, "unable to run " + unit.kind);
+        _out << unit.id << (ok ? " done" : " failed") << (recorded ? "\n" : ", but its lease was lost\n");
+        _out.flush();
+        ++processed;
+        _queue.requeueExpired(_lease);
+    }
+    _out << "processed " << processed << " units\n";
+    return 0;
+}
+
+int status(WorkQueue &_queue, QTextStream &_out)
+{
+    const auto counts = _queue.status();
+    _out << "pending " << counts.pending << "\nclaimed " << counts.claimed
+         << "\ndone    " << counts.done << "\nfailed  " << counts.failed << '\n';
+
+    quint64 perftNodes = 0;
+    QMap<QString, int> outcomes;
+    for (const auto& object : _queue.results()) {
+        const auto result = object.value("result").toObject();
+        const auto kind = object.value("kind").toString();
+        if(kind == "perft")
+            perftNodes += result.value("nodes").toString().toULongLong();
+        else if(kind == "solve")
+            ++outcomes[result.value("outcome").toString()];
+        else if(kind == "selfplay") {
+            for (const auto& game : result.value("games").toArray())
+                ++outcomes[game.toObject().value("result").toString()];
+        }
+    }
+    if(perftNodes)
+        _out << "perft nodes " << perftNodes << '\n';
+    for (auto it = outcomes.cbegin(); it != outcomes.cend(); ++it)
+        _out << it.key() << ' ' << it.value() << '\n';
+    return 0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CheckersJobs");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Splits analysis jobs into resumable units and works through them.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "split <kind> ..., work, status, perft <variant> <depth> or rules");
+    QCommandLineOption queueOption("queue", "Queue directory; may be on a shared filesystem.", "dir", "checkers-jobs");
+    QCommandLineOption workerOption("worker", "Worker name recorded in leases.", "name",
+                                    QHostInfo::localHostName() + '-' + QString::number(QCoreApplication::applicationPid()));
+    QCommandLineOption leaseOption("lease", "Seconds without a heartbeat before a claimed unit is requeued.", "seconds", "600");
+    QCommandLineOption attemptsOption("attempts", "Attempts before a unit is moved to failed.", "count", "3");
+    parser.addOptions({ queueOption, workerOption, leaseOption, attemptsOption });
+    parser.process(app);
+
+    MetricsThread metrics;
+
+    QTextStream out(stdout);
+    const auto args = parser.positionalArguments();
+    const auto command = args.value(0);
+    if(command == "perft")
+        return localPerft(args.mid(1), out);
+    if(command == "rules")
+        return rules(out);
+
+    WorkQueue queue(parser.value(queueOption), parser.value(attemptsOption).toInt());
+    if(!queue.initialize()) {
+        out << "unable to create queue in " << parser.value(queueOption) << '\n';
+        return 1;
+    }
+
+    if(command == "split")
+        return split(args.mid(1), queue, out);
+    if(command == "work")
+        return work(queue, parser.value(workerOption), parser.value(leaseOption).toInt(), out);
+    if(command == "status")
+        return status(queue, out);
+
+    parser.showHelp(1);
+}
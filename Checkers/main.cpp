@@ -1,11 +1,71 @@
-#include "mainwindow.hpp"
-
-#include <QApplication>
-
-int main(int argc, char *argv[])
-{
-    QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
-    return a.exec();
-}
+#include "mainwindow.hpp"
+#include "trace.hpp"
+#include "metricsendpoint.hpp"
+#include "startupreport.hpp"
+#include "inputrecorder.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    StartupReport::begin();
+    const bool tracing = qEnvironmentVariableIsSet("CHECKERS_TRACE");
+    Trace::setEnabled(tracing);
+
+    // Has to be decided before QApplication creates the first GL context.
+    for (int i = 1; i < argc; ++i) {
+        if(qstrcmp(argv[i], "--software-gl") == 0) {
+            qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+            QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+        }
+    }
+
+    QApplication a(argc, argv);
+    StartupReport::mark("application");
+    MetricsEndpoint::setupFromEnvironment(&a);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption engineOption("engine", "Let the engine play a side: white or black.", "side");
+    QCommandLineOption moveTimeOption("move-time", "Engine time per move in milliseconds.", "ms", "1000");
+    QCommandLineOption noPonderOption("no-ponder", "Do not think on the opponent's time.");
+    QCommandLineOption hashOption("hash", "Engine transposition table size in megabytes.", "mb", QString::number(Engine::defaultHashMegabytes));
+    QCommandLineOption rendererOption("renderer", "Board renderer: widgets or gl.", "renderer", "widgets");
+    QCommandLineOption softwareGlOption("software-gl", "Use the software OpenGL rasterizer (Mesa llvmpipe).");
+    QCommandLineOption variantOption("variant", "Rules: classic, american, russian, brazilian, international or pool.", "name", "classic");
+    QCommandLineOption openOption("open", "Open a game archive for replay.", "file");
+    QCommandLineOption recordOption("record", "Record board input, resizes and engine moves to an input log.", "file");
+    parser.addOptions({ engineOption, moveTimeOption, noPonderOption, hashOption, rendererOption, softwareGlOption, variantOption, openOption, recordOption });
+    parser.process(a);
+    StartupReport::mark("command line");
+
+    Variant variant = Variant::Classic;
+    if(!variantFromName(parser.value(variantOption).toStdString(), variant))
+        qWarning() << "Unknown variant" << parser.value(variantOption) << "- playing classic";
+
+    MainWindow w(variant);
+    if(parser.value(rendererOption) == "gl")
+        w.useOpenGLRenderer();
+    int engineSide = -1;
+    if(parser.isSet(engineOption)) {
+        w.setEngineHashSize(parser.value(hashOption).toInt());
+        const auto side = parser.value(engineOption) == "white" ? Checker::Type::White : Checker::Type::Black;
+        w.enableEngine(side, parser.value(moveTimeOption).toLongLong(), !parser.isSet(noPonderOption));
+        engineSide = static_cast<int>(side);
+    }
+    if(parser.isSet(recordOption)) {
+        auto recorder = new InputRecorder(&w, engineSide);
+        if(!recorder->open(parser.value(recordOption)))
+            qWarning() << "Unable to record input to" << parser.value(recordOption);
+    }
+    if(parser.isSet(openOption))
+        w.openArchive(parser.value(openOption));
+    w.show();
+    const auto result = a.exec();
+
+    if(tracing)
+        Trace::exportChromeJson(Trace::defaultFileName());
+    return result;
+}
@@ -1,27 +1,401 @@
-#include "mainwindow.hpp"
-
-#include <QApplication>
-#include <QScreen>
-#include <QPainter>
-#include <QVBoxLayout>
-
-MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent)
-    , board(new Checkerboard(8, this))
-    , manager(new GameManager(this))
-{
-    connect(manager, &GameManager::nextMove, board, &Checkerboard::onNextMove);
-    connect(board, &Checkerboard::endOfMove, manager, &GameManager::onEndOfMove);
-    setupUi();
-    manager->start();
-}
-
-void MainWindow::setupUi()
-{
-    const auto screenCenter = QApplication::screens().first()->availableGeometry().center();
-    QRect r = frameGeometry();
-    r.moveCenter(screenCenter);
-    move(r.topLeft());
-
-    setCentralWidget(board);
-}
+#include "mainwindow.hpp"
+#include "trace.hpp"
+#ifndef CHECKERS_LOW_MEMORY
+#include "glboardview.hpp"
+#endif
+#include "startupreport.hpp"
+
+#include <QApplication>
+#include <QScreen>
+#include <QPainter>
+#include <QVBoxLayout>
+#include <QAction>
+#include <QDebug>
+#include <QTimer>
+#include <QDockWidget>
+#include <QTreeView>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QStatusBar>
+
+namespace {
+// The deferred startup runs this long after the window is shown even if no board frame arrives.
+const int deferredStartupFallbackMs = 1000;
+}
+
+MainWindow::MainWindow(QWidget *parent)
+    : MainWindow(8, parent)
+{}
+
+MainWindow::MainWindow(const int _boardEdgeSize, QWidget *parent)
+    : MainWindow(_boardEdgeSize, Variant::Classic, parent)
+{}
+
+MainWindow::MainWindow(const Variant _variant, QWidget *parent)
+    : MainWindow(variantInfo(_variant).edge, _variant, parent)
+{}
+
+MainWindow::MainWindow(const int _boardEdgeSize, const Variant _variant, QWidget *parent)
+    : QMainWindow(parent)
+    , board(new BoardWidget(_boardEdgeSize, _variant, this))
+    , manager(new GameManager(this))
+    , engine(nullptr)
+    , analysis(new GameTreeModel(board->getBoardSize(), this))
+    , analysisDock(nullptr)
+    , replayPanel(nullptr)
+    , replayDock(nullptr)
+    , gamePosition(board->toPosition(Checker::Type::White))
+    , gameNode(AnalysisTree::rootNode)
+    , engineRequested(false)
+    , engineMoveTimeMs(1000)
+    , enginePonder(true)
+    , engineHashMegabytes(Engine::defaultHashMegabytes)
+    , firstFramePainted(false)
+    , startupDone(false)
+    , reviewMode(false)
+{
+    StartupReport::mark("board widgets");
+    connect(manager, &GameManager::nextMove, board, &BoardWidget::onNextMove);
+    connect(board, &BoardWidget::noMoves, manager, &GameManager::onNoMoves);
+    connect(board, &BoardWidget::endOfMove, this, &MainWindow::onBoardMoveFinished);
+    connect(manager, &GameManager::gameOver, this, &MainWindow::onGameOver);
+    manager->resetHistory(gamePosition);
+    gameLine.insert(gamePosition.hash(), gameNode);
+    setupUi();
+    StartupReport::mark("main window");
+}
+
+bool MainWindow::isStartupDone() const
+{
+    return startupDone;
+}
+
+bool MainWindow::eventFilter(QObject *_watched, QEvent *_event)
+{
+    // Everything not needed for the first frame waits until the board has been painted. The
+    // frame is complete, children and flush included, by the time the queued call runs.
+    if(_event->type() == QEvent::Paint && _watched == centralWidget() && !firstFramePainted) {
+        firstFramePainted = true;
+        QTimer::singleShot(0, this, [this] {
+            StartupReport::markFirstFrame();
+            runDeferredStartup();
+        });
+    }
+    return QMainWindow::eventFilter(_watched, _event);
+}
+
+void MainWindow::showEvent(QShowEvent *_event)
+{
+    QMainWindow::showEvent(_event);
+    if(!startupDone)
+        QTimer::singleShot(deferredStartupFallbackMs, this, &MainWindow::runDeferredStartup);
+}
+
+void MainWindow::runDeferredStartup()
+{
+    if(startupDone)
+        return;
+
+    if(engineRequested) {
+        startEngine();
+        StartupReport::mark("engine");
+    }
+    if(!reviewMode) {
+        manager->start();
+        StartupReport::mark("game start");
+    }
+    startupDone = true;
+    emit startupFinished();
+
+    if(board->hasCheckerImages())
+        StartupReport::finish();
+    else
+        connect(board, &BoardWidget::checkerImagesReady, this, [] { StartupReport::finish(); });
+}
+
+BoardWidget *MainWindow::getBoard() const
+{
+    return board;
+}
+
+const GameHistory &MainWindow::getHistory() const
+{
+    return manager->history();
+}
+
+void MainWindow::enableEngine(Checker::Type _side, qint64 _moveTimeMs, bool _ponder)
+{
+    engineRequested = true;
+    engineMoveTimeMs = _moveTimeMs;
+    enginePonder = _ponder;
+    manager->setEngineSide(_side);
+    // The controller allocates its hash table and thread, so it is created after the first frame.
+    if(startupDone)
+        startEngine();
+}
+
+void MainWindow::setExternalEngine(Checker::Type _side)
+{
+    manager->setEngineSide(_side);
+}
+
+void MainWindow::setEngineHashSize(int _megabytes)
+{
+    engineHashMegabytes = _megabytes;
+    if(engine)
+        engine->setHashSize(engineHashMegabytes);
+}
+
+void MainWindow::startEngine()
+{
+    if(!engine) {
+        engine = new EngineController(this);
+        connect(manager, &GameManager::engineToMove, this, [this](Checker::Type _type) {
+            engine->requestMove(board->toPosition(_type), manager->history());
+        });
+        connect(engine, &EngineController::analysisReady, this, &MainWindow::onAnalysisReady);
+        // Announced before the board plays it, so an input recorder logs the engine move ahead of its end of move.
+        connect(engine, &EngineController::moveReady, this, &MainWindow::engineMoveReady);
+        connect(engine, &EngineController::moveReady, board, &BoardWidget::playMove);
+        if(engineHashMegabytes != Engine::defaultHashMegabytes)
+            engine->setHashSize(engineHashMegabytes);
+    }
+    engine->setMoveTime(engineMoveTimeMs);
+    engine->setPondering(enginePonder);
+}
+
+void MainWindow::useOpenGLRenderer()
+{
+#ifdef CHECKERS_LOW_MEMORY
+    qWarning() << "The OpenGL renderer is not available in the low-memory build";
+#else
+    if(centralWidget() != board)
+        return;
+
+    // The Checkerboard keeps owning the game state and input rules; it just is not shown.
+    takeCentralWidget();
+    board->setParent(this);
+    board->hide();
+    auto view = new GLBoardView(board, this);
+    view->installEventFilter(this);
+    setCentralWidget(view);
+#endif
+}
+
+void MainWindow::setupUi()
+{
+    const auto screenCenter = QApplication::screens().first()->availableGeometry().center();
+    QRect r = frameGeometry();
+    r.moveCenter(screenCenter);
+    move(r.topLeft());
+
+    setCentralWidget(board);
+    board->installEventFilter(this);
+
+    auto traceAction = new QAction(tr("Toggle tracing"), this);
+    traceAction->setShortcut(QKeySequence(Qt::Key_F12));
+    connect(traceAction, &QAction::triggered, this, &MainWindow::onToggleTracing);
+    addAction(traceAction);
+
+    auto analysisAction = new QAction(tr("Analysis panel"), this);
+    analysisAction->setShortcut(QKeySequence(Qt::Key_F8));
+    connect(analysisAction, &QAction::triggered, this, &MainWindow::onToggleAnalysis);
+    addAction(analysisAction);
+
+    auto openAction = new QAction(tr("Open game archive"), this);
+    openAction->setShortcut(QKeySequence::Open);
+    connect(openAction, &QAction::triggered, this, &MainWindow::onOpenArchive);
+    addAction(openAction);
+
+    auto newGameAction = new QAction(tr("New game"), this);
+    newGameAction->setShortcut(QKeySequence::New);
+    connect(newGameAction, &QAction::triggered, this, &MainWindow::onNewGame);
+    addAction(newGameAction);
+}
+
+void MainWindow::ensureAnalysisDock()
+{
+    if(analysisDock)
+        return;
+
+    auto analysisView = new QTreeView();
+    analysisView->setModel(analysis);
+    // Fixed row heights let the view lay out only the visible rows of very large trees.
+    analysisView->setUniformRowHeights(true);
+    analysisView->header()->setSectionResizeMode(GameTreeModel::MoveColumn, QHeaderView::Stretch);
+    analysisView->header()->setStretchLastSection(false);
+
+    analysisDock = new QDockWidget(tr("Analysis"), this);
+    analysisDock->setObjectName("AnalysisDock");
+    analysisDock->setWidget(analysisView);
+    addDockWidget(Qt::RightDockWidgetArea, analysisDock);
+    analysisDock->hide();
+}
+
+void MainWindow::ensureReplayDock()
+{
+    if(replayDock)
+        return;
+
+    replayPanel = new ReplayPanel(board->getBoardSize(), board->variant(), this);
+    replayDock = new QDockWidget(tr("Replay"), this);
+    replayDock->setObjectName("ReplayDock");
+    replayDock->setWidget(replayPanel);
+    addDockWidget(Qt::RightDockWidgetArea, replayDock);
+    replayDock->hide();
+    connect(replayPanel, &ReplayPanel::gameSelected, this, &MainWindow::onReplayGameSelected);
+    connect(replayPanel, &ReplayPanel::positionSelected, this, &MainWindow::onReplayPositionSelected);
+}
+
+void MainWindow::onToggleAnalysis()
+{
+    ensureAnalysisDock();
+    analysisDock->setVisible(!analysisDock->isVisible());
+}
+
+bool MainWindow::openArchive(const QString &_fileName)
+{
+    ensureReplayDock();
+    QString error;
+    if(!replayPanel->loadArchive(_fileName, &error)) {
+        qWarning() << "Unable to load" << _fileName << ":" << error;
+        return false;
+    }
+    replayDock->show();
+    return true;
+}
+
+void MainWindow::onOpenArchive()
+{
+    const auto fileName = QFileDialog::getOpenFileName(this, tr("Open game archive"), QString(), tr("Game archives (*.pdn *.txt);;All files (*)"));
+    if(fileName.isEmpty())
+        return;
+
+    ensureReplayDock();
+    QString error;
+    if(!replayPanel->loadArchive(fileName, &error)) {
+        QMessageBox::warning(this, tr("Open game archive"), error);
+        return;
+    }
+    replayDock->show();
+}
+
+Position MainWindow::startPosition() const
+{
+    const auto variant = board->variant();
+    return variant == Variant::Classic ? Position::initial(board->getBoardSize()) : Position::initial(variant);
+}
+
+// Also the way out of reviewing an archive: the replay closes and a live game starts again.
+void MainWindow::onNewGame()
+{
+    // The manager stops first, so a move the board finishes while being reset starts no turn.
+    manager->finish();
+    board->setPosition(startPosition());
+    if(engine)
+        engine->cancel();
+    if(replayDock)
+        replayDock->hide();
+    reviewMode = false;
+
+    gamePosition = board->toPosition(Checker::Type::White);
+    gameNode = AnalysisTree::rootNode;
+    gameLine.clear();
+    gameLine.insert(gamePosition.hash(), gameNode);
+    manager->resetHistory(gamePosition);
+    statusBar()->clearMessage();
+
+    // Before the first frame, runDeferredStartup() starts the game.
+    if(startupDone)
+        manager->start();
+}
+
+void MainWindow::onReplayGameSelected(int _index)
+{
+    // Reviewing an archive ends the live game; its moves become a line of the analysis tree.
+    reviewMode = true;
+    manager->finish();
+    if(engine)
+        engine->cancel();
+    gameNode = AnalysisTree::none;
+    gameLine.clear();
+
+    const auto& record = replayPanel->game(_index);
+    if(record.start.hash() != startPosition().hash())
+        return;
+    auto node = AnalysisTree::rootNode;
+    for (const auto& move : record.moves)
+        node = analysis->addMove(node, move);
+}
+
+void MainWindow::onReplayPositionSelected(const Position &_position)
+{
+    board->setPosition(_position);
+}
+
+void MainWindow::onBoardMoveFinished()
+{
+    const auto next = Position::opponent(gamePosition.sideToMove());
+    const auto after = board->toPosition(next == Position::Side::White ? Checker::Type::White : Checker::Type::Black);
+
+    auto played = AnalysisTree::none;
+    if(gameNode != AnalysisTree::none) {
+        Position::MoveList moves;
+        gamePosition.generateMoves(moves);
+        for (const auto& move : moves) {
+            if(gamePosition.play(move).hash() == after.hash()) {
+                played = analysis->addMove(gameNode, move);
+                break;
+            }
+        }
+    }
+    if(played != AnalysisTree::none)
+        gameLine.insert(after.hash(), played);
+    else
+        played = gameLine.value(after.hash(), AnalysisTree::none);
+    gameNode = played;
+    gamePosition = after;
+
+    // The manager is told last: a ponder result that is already finished is played from inside
+    // onEndOfMove(), which enters this slot again and must see the updated game position.
+    manager->onEndOfMove(after);
+}
+
+void MainWindow::onGameOver(GameHistory::Outcome _outcome)
+{
+    if(engine)
+        engine->cancel();
+
+    QString text;
+    switch (_outcome) {
+    case GameHistory::Outcome::WhiteWins: text = tr("White wins"); break;
+    case GameHistory::Outcome::BlackWins: text = tr("Black wins"); break;
+    case GameHistory::Outcome::Repetition: text = tr("Draw by threefold repetition"); break;
+    case GameHistory::Outcome::MoveLimit: text = tr("Draw: no capture or man move for %1 moves").arg(manager->history().quietPlies() / 2); break;
+    case GameHistory::Outcome::Ongoing: return;
+    }
+    statusBar()->showMessage(text);
+}
+
+void MainWindow::onAnalysisReady(const Position &_position, const Engine::Result &_result)
+{
+    if(gameNode != AnalysisTree::none && _position.hash() == gamePosition.hash())
+        analysis->addAnalysis(gameNode, _position, _result);
+}
+
+void MainWindow::onToggleTracing()
+{
+    if(!Trace::isEnabled()) {
+        Trace::clear();
+        Trace::setEnabled(true);
+        return;
+    }
+
+    Trace::setEnabled(false);
+    const auto fileName = Trace::defaultFileName();
+    if(Trace::exportChromeJson(fileName))
+        qDebug() << "Trace written to" << fileName;
+    else
+        qWarning() << "Unable to write trace to" << fileName;
+}
@@ -1,19 +1,89 @@
-#pragma once
-
-#include "gamemanager.hpp"
-#include "checkerboard.hpp"
-#include <QMainWindow>
-
-class MainWindow : public QMainWindow
-{
-    Q_OBJECT
-public:
-    MainWindow(QWidget *parent = nullptr);
-
-private:
-    void setupUi();
-
-private:
-    Checkerboard *board;
-    GameManager *manager;
-};
+#pragma once
+
+#include "gamemanager.hpp"
+#ifdef CHECKERS_LOW_MEMORY
+#include "compactboard.hpp"
+#else
+#include "checkerboard.hpp"
+#endif
+#include "enginecontroller.hpp"
+#include "gametreemodel.hpp"
+#include "replaypanel.hpp"
+#include <QMainWindow>
+#include <QHash>
+
+class QDockWidget;
+
+#ifdef CHECKERS_LOW_MEMORY
+using BoardWidget = CompactBoard;
+#else
+using BoardWidget = Checkerboard;
+#endif
+
+class MainWindow : public QMainWindow
+{
+    Q_OBJECT
+public:
+    MainWindow(QWidget *parent = nullptr);
+    explicit MainWindow(const int _boardEdgeSize, QWidget *parent = nullptr);
+    explicit MainWindow(const Variant _variant, QWidget *parent = nullptr);
+    MainWindow(const int _boardEdgeSize, const Variant _variant, QWidget *parent = nullptr);
+
+    BoardWidget *getBoard() const;
+    const GameHistory& getHistory() const;
+    void enableEngine(Checker::Type _side, qint64 _moveTimeMs, bool _ponder);
+    void setEngineHashSize(int _megabytes);
+    // _side is played by moves passed to getBoard()->playMove() from outside; no search runs.
+    void setExternalEngine(Checker::Type _side);
+    void useOpenGLRenderer();
+    bool openArchive(const QString &_fileName);
+    bool isStartupDone() const;
+
+signals:
+    void startupFinished();
+    void engineMoveReady(const Position::Move &_move);
+
+protected:
+    bool eventFilter(QObject *_watched, QEvent *_event) override;
+    void showEvent(QShowEvent *_event) override;
+
+private slots:
+    void onToggleTracing();
+    void onToggleAnalysis();
+    void runDeferredStartup();
+    void onBoardMoveFinished();
+    void onAnalysisReady(const Position &_position, const Engine::Result &_result);
+    void onOpenArchive();
+    void onNewGame();
+    void onReplayGameSelected(int _index);
+    void onReplayPositionSelected(const Position &_position);
+    void onGameOver(GameHistory::Outcome _outcome);
+
+private:
+    void setupUi();
+    void startEngine();
+    void ensureAnalysisDock();
+    void ensureReplayDock();
+    Position startPosition() const;
+
+private:
+    BoardWidget *board;
+    GameManager *manager;
+    EngineController *engine;
+    GameTreeModel *analysis;
+    QDockWidget *analysisDock;
+    ReplayPanel *replayPanel;
+    QDockWidget *replayDock;
+    Position gamePosition;
+    quint32 gameNode;
+    // Node of every position the game line has reached, to find the line again after a move
+    // the tree could not follow.
+    QHash<quint64, quint32> gameLine;
+    bool engineRequested;
+    qint64 engineMoveTimeMs;
+    bool enginePonder;
+    int engineHashMegabytes;
+    bool firstFramePainted;
+    bool startupDone;
+    bool reviewMode;
+};
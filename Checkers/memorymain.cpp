@@ -0,0 +1,138 @@
+#include "mainwindow.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include <functional>
+
+namespace {
+
+#ifdef CHECKERS_LOW_MEMORY
+const int defaultBudgetMegabytes = 48;
+#else
+const int defaultBudgetMegabytes = 128;
+#endif
+
+struct Usage
+{
+    qint64 residentKb = -1;
+    qint64 peakKb = -1;
+};
+
+// Reads VmRSS and VmHWM; both stay -1 where /proc is not available.
+Usage readUsage()
+{
+    Usage usage;
+    QFile status("/proc/self/status");
+    if(!status.open(QIODevice::ReadOnly))
+        return usage;
+
+    for (const auto& line : status.readAll().split('\n')) {
+        const auto fields = line.simplified().split(' ');
+        if(fields.size() < 2)
+            continue;
+        if(fields[0] == "VmRSS:")
+            usage.residentKb = fields[1].toLongLong();
+        else if(fields[0] == "VmHWM:")
+            usage.peakKb = fields[1].toLongLong();
+    }
+    return usage;
+}
+
+bool waitFor(const std::function<bool()> &_condition, const int _timeoutMs)
+{
+    QEventLoop loop;
+    QTimer deadline;
+    deadline.setSingleShot(true);
+    deadline.start(_timeoutMs);
+    while(!_condition() && deadline.isActive())
+        loop.processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents, 10);
+    return _condition();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("CheckersMemory");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Plays an engine game in the main window and checks resident memory against a budget.");
+    parser.addHelpOption();
+    QCommandLineOption budgetOption("budget-mb", "Peak resident memory allowed, in megabytes.", "mb", QString::number(defaultBudgetMegabytes));
+    QCommandLineOption pliesOption("plies", "Plies to play; the engine plays black, white plays its first legal move.", "plies", "40");
+    QCommandLineOption moveTimeOption("move-time", "Engine time per move in milliseconds.", "ms", "50");
+    QCommandLineOption hashOption("hash", "Engine transposition table size in megabytes.", "mb", QString::number(Engine::defaultHashMegabytes));
+    QCommandLineOption variantOption("variant", "Rules to play.", "name", "classic");
+    parser.addOptions({ budgetOption, pliesOption, moveTimeOption, hashOption, variantOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    out << "stage             rss MB  peak MB\n";
+    auto report = [&](const char *_stage) {
+        const auto usage = readUsage();
+        out << QString(_stage).leftJustified(16) << qSetFieldWidth(8) << usage.residentKb / 1024.0
+            << qSetFieldWidth(9) << usage.peakKb / 1024.0 << qSetFieldWidth(0) << '\n';
+        out.flush();
+    };
+    report("application");
+
+    Variant variant = Variant::Classic;
+    if(!variantFromName(parser.value(variantOption).toStdString(), variant)) {
+        out << "unknown variant " << parser.value(variantOption) << '\n';
+        return 2;
+    }
+
+    MainWindow window(variant);
+    window.setEngineHashSize(parser.value(hashOption).toInt());
+    window.enableEngine(Checker::Type::Black, parser.value(moveTimeOption).toLongLong(), false);
+    window.show();
+    if(!waitFor([&] { return window.isStartupDone(); }, 10000)) {
+        out << "startup did not finish\n";
+        return 2;
+    }
+    report("window");
+
+    auto board = window.getBoard();
+    int plies = 0;
+    QObject::connect(board, &BoardWidget::endOfMove, &window, [&plies] { ++plies; });
+
+    const auto maxPlies = parser.value(pliesOption).toInt();
+    const auto moveTimeout = parser.value(moveTimeOption).toInt() * 20 + 1000;
+    while(plies < maxPlies) {
+        const auto played = plies;
+        if(plies % 2 == 0) {
+            Position::MoveList moves;
+            board->toPosition(Checker::Type::White).generateMoves(moves);
+            if(moves.empty())
+                break;
+            board->playMove(moves[0]);
+        }
+        if(!waitFor([&] { return plies > played; }, moveTimeout))
+            break;
+    }
+    out << plies << " plies played\n";
+    report("game");
+    // A short game only counts when it ended by the rules; otherwise the engine never answered.
+    if(plies < maxPlies && window.getHistory().outcome() == GameHistory::Outcome::Ongoing) {
+        out << "the game stalled after " << plies << " plies\n";
+        return 2;
+    }
+
+    const auto peakMegabytes = readUsage().peakKb / 1024.0;
+    const auto budget = parser.value(budgetOption).toDouble();
+    if(peakMegabytes < 0) {
+        out << "resident memory is not available on this platform\n";
+        return 0;
+    }
+    out << "peak " << peakMegabytes << " MB, budget " << budget << " MB: " << (peakMegabytes <= budget ? "ok" : "over budget") << '\n';
+    return peakMegabytes <= budget ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+#include "metrics.hpp"
+
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Histogram buckets are upper bounds in microseconds.
+const std::array<qint64, 14> bucketBounds = {
+    10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000
+};
+// Per-histogram layout: one slot per bucket, then +Inf, sum (ns) and count.
+const int histogramSlots = static_cast<int>(bucketBounds.size()) + 3;
+
+enum class Kind { Counter, Histogram };
+
+struct Definition
+{
+    QByteArray name;
+    QByteArray help;
+    QByteArray labels;
+    Kind kind;
+    int slot;
+};
+
+struct Shard
+{
+    std::array<std::atomic<quint64>, Metrics::maxSlots> values;
+
+    Shard()
+    {
+        for (auto& value : values)
+            value.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct Registry
+{
+    QMutex mutex;
+    std::vector<Definition> definitions;
+    std::vector<std::unique_ptr<Shard>> shards;
+    // Shards of threads that have exited, counts intact, waiting for a new thread to take them.
+    std::vector<Shard*> freeShards;
+    int nextSlot = 0;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+int registerMetric(const char *_name, const char *_help, const QByteArray &_labels, Kind _kind)
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    for (const auto& definition : reg.definitions) {
+        if(definition.name == _name && definition.labels == _labels)
+            return definition.slot;
+    }
+
+    const auto size = _kind == Kind::Counter ? 1 : histogramSlots;
+    if(reg.nextSlot + size > Metrics::maxSlots)
+        qFatal("Metrics: slot capacity exhausted registering %s", _name);
+
+    Definition definition { _name, _help, _labels, _kind, reg.nextSlot };
+    reg.nextSlot += size;
+    reg.definitions.push_back(definition);
+    return definition.slot;
+}
+
+// Returns the thread's shard to the free list when the thread exits, so pool threads that
+// expire and respawn reuse shards and their number stays at the peak of live threads.
+struct ShardLease
+{
+    Shard *shard = nullptr;
+
+    ~ShardLease()
+    {
+        if(!shard)
+            return;
+        auto& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        reg.freeShards.push_back(shard);
+    }
+};
+
+// Every thread writes only to its own shard, so updates are uncontended relaxed adds.
+// The registry lock is taken once per thread, when it takes a shard.
+Shard& localShard()
+{
+    thread_local ShardLease lease;
+    if(!lease.shard) {
+        auto& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        if(!reg.freeShards.empty()) {
+            lease.shard = reg.freeShards.back();
+            reg.freeShards.pop_back();
+        }
+        else {
+            reg.shards.push_back(std::make_unique<Shard>());
+            lease.shard = reg.shards.back().get();
+        }
+    }
+    return *lease.shard;
+}
+
+void addToSlot(int _slot, quint64 _value)
+{
+    localShard().values[_slot].fetch_add(_value, std::memory_order_relaxed);
+}
+
+QByteArray withLabels(const QByteArray &_name, const QByteArray &_labels, const QByteArray &_extra = QByteArray())
+{
+    QByteArray all = _labels;
+    if(!_extra.isEmpty())
+        all += (all.isEmpty() ? "" : ",") + _extra;
+    if(all.isEmpty())
+        return _name;
+    return _name + '{' + all + '}';
+}
+
+}
+
+Metrics::Counter::Counter(const char *_name, const char *_help, const QByteArray &_labels)
+    : slot(registerMetric(_name, _help, _labels, Kind::Counter))
+{}
+
+void Metrics::Counter::add(quint64 _value) const
+{
+    addToSlot(slot, _value);
+}
+
+Metrics::Histogram::Histogram(const char *_name, const char *_help, const QByteArray &_labels)
+    : slot(registerMetric(_name, _help, _labels, Kind::Histogram))
+{}
+
+void Metrics::Histogram::observe(qint64 _nanoseconds) const
+{
+    const auto micros = _nanoseconds / 1000;
+    int bucket = 0;
+    while(bucket < static_cast<int>(bucketBounds.size()) && micros > bucketBounds[bucket])
+        ++bucket;
+
+    auto& values = localShard().values;
+    values[slot + bucket].fetch_add(1, std::memory_order_relaxed);
+    values[slot + histogramSlots - 2].fetch_add(static_cast<quint64>(qMax<qint64>(_nanoseconds, 0)), std::memory_order_relaxed);
+    values[slot + histogramSlots - 1].fetch_add(1, std::memory_order_relaxed);
+}
+
+QByteArray Metrics::prometheusText()
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    QVector<quint64> totals(reg.nextSlot, 0);
+    for (const auto& shard : reg.shards) {
+        for (int i = 0; i < reg.nextSlot; ++i)
+            totals[i] += shard->values[i].load(std::memory_order_relaxed);
+    }
+
+    QMap<QByteArray, QVector<const Definition*>> families;
+    for (const auto& definition : reg.definitions)
+        families[definition.name].append(&definition);
+
+    QByteArray out;
+    for (auto it = families.cbegin(); it != families.cend(); ++it) {
+        const auto& first = *it.value().first();
+        out += "# HELP " + first.name + ' ' + first.help + '\n';
+        out += "# TYPE " + first.name + (first.kind == Kind::Counter ? " counter\n" : " histogram\n");
+
+        for (auto definition : it.value()) {
+            if(definition->kind == Kind::Counter) {
+                out += withLabels(definition->name, definition->labels) + ' ' + QByteArray::number(totals[definition->slot]) + '\n';
+                continue;
+            }
+
+            quint64 cumulative = 0;
+            for (int bucket = 0; bucket <= static_cast<int>(bucketBounds.size()); ++bucket) {
+                cumulative += totals[definition->slot + bucket];
+                const auto bound = bucket < static_cast<int>(bucketBounds.size())
+                        ? QByteArray::number(bucketBounds[bucket] / 1e6, 'g', 6)
+                        : QByteArray("+Inf");
+                out += withLabels(definition->name + "_bucket", definition->labels, "le=\"" + bound + '"')
+                        + ' ' + QByteArray::number(cumulative) + '\n';
+            }
+            const auto sumNs = totals[definition->slot + histogramSlots - 2];
+            out += withLabels(definition->name + "_sum", definition->labels) + ' ' + QByteArray::number(sumNs / 1e9, 'g', 9) + '\n';
+            out += withLabels(definition->name + "_count", definition->labels) + ' '
+                    + QByteArray::number(totals[definition->slot + histogramSlots - 1]) + '\n';
+        }
+    }
+    return out;
+}
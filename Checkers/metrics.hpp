@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+
+class Metrics
+{
+public:
+    static constexpr int maxSlots = 4096;
+
+    class Counter
+    {
+    public:
+        Counter(const char *_name, const char *_help, const QByteArray &_labels = QByteArray());
+
+        void add(quint64 _value = 1) const;
+
+    private:
+        int slot;
+    };
+
+    class Histogram
+    {
+    public:
+        Histogram(const char *_name, const char *_help, const QByteArray &_labels = QByteArray());
+
+        void observe(qint64 _nanoseconds) const;
+
+    private:
+        int slot;
+    };
+
+    static QByteArray prometheusText();
+
+private:
+    Metrics() = delete;
+};
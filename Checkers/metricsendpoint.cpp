@@ -0,0 +1,146 @@
+#include "metricsendpoint.hpp"
+#include "metrics.hpp"
+
+#include <QFile>
+#include <QHostAddress>
+#include <QSocketNotifier>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QDebug>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+int signalPipe[2] = { -1, -1 };
+}
+#endif
+
+MetricsEndpoint::MetricsEndpoint(QObject *_parent)
+    : QObject(_parent)
+    , server(new QTcpServer(this))
+    , signalNotifier(nullptr)
+{
+    connect(server, &QTcpServer::newConnection, this, &MetricsEndpoint::onNewConnection);
+}
+
+MetricsEndpoint::~MetricsEndpoint()
+{
+#ifdef Q_OS_UNIX
+    if(signalNotifier) {
+        std::signal(SIGUSR1, SIG_DFL);
+        ::close(signalPipe[0]);
+        ::close(signalPipe[1]);
+        signalPipe[0] = signalPipe[1] = -1;
+    }
+#endif
+}
+
+bool MetricsEndpoint::listen(quint16 _port)
+{
+    return server->listen(QHostAddress::LocalHost, _port);
+}
+
+void MetricsEndpoint::dumpOnSignal(const QString &_fileName)
+{
+    dumpFileName = _fileName;
+#ifdef Q_OS_UNIX
+    if(signalNotifier || ::socketpair(AF_UNIX, SOCK_STREAM, 0, signalPipe) != 0)
+        return;
+
+    signalNotifier = new QSocketNotifier(signalPipe[1], QSocketNotifier::Read, this);
+    connect(signalNotifier, &QSocketNotifier::activated, this, &MetricsEndpoint::onSignalReceived);
+    std::signal(SIGUSR1, &MetricsEndpoint::signalHandler);
+#endif
+}
+
+void MetricsEndpoint::setupFromEnvironment(QObject *_parent)
+{
+    const auto port = qEnvironmentVariableIntValue("CHECKERS_METRICS_PORT");
+    const auto dumpFile = qEnvironmentVariable("CHECKERS_METRICS_DUMP");
+    if(port <= 0 && dumpFile.isEmpty())
+        return;
+
+    auto endpoint = new MetricsEndpoint(_parent);
+    if(port > 0 && !endpoint->listen(static_cast<quint16>(port)))
+        qWarning() << "Metrics: unable to listen on port" << port;
+    if(!dumpFile.isEmpty())
+        endpoint->dumpOnSignal(dumpFile);
+}
+
+void MetricsEndpoint::onNewConnection()
+{
+    while(auto socket = server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+            // Any request is answered with the full exposition; the request line is not parsed.
+            if(!socket->canReadLine())
+                return;
+            socket->readAll();
+
+            const auto body = Metrics::prometheusText();
+            QByteArray response = "HTTP/1.0 200 OK\r\n"
+                                  "Content-Type: text/plain; version=0.0.4\r\n"
+                                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                                  "Connection: close\r\n\r\n";
+            socket->write(response + body);
+            socket->disconnectFromHost();
+        });
+    }
+}
+
+void MetricsEndpoint::onSignalReceived()
+{
+#ifdef Q_OS_UNIX
+    signalNotifier->setEnabled(false);
+    char byte;
+    if(::read(signalPipe[1], &byte, sizeof(byte)) < 0)
+        qWarning() << "Metrics: failed to drain signal pipe";
+
+    QFile file(dumpFileName);
+    if(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        file.write(Metrics::prometheusText());
+    else
+        qWarning() << "Metrics: unable to write" << dumpFileName;
+
+    signalNotifier->setEnabled(true);
+#endif
+}
+
+void MetricsEndpoint::signalHandler(int _signal)
+{
+#ifdef Q_OS_UNIX
+    Q_UNUSED(_signal);
+    const char byte = 1;
+    if(::write(signalPipe[0], &byte, sizeof(byte)) < 0)
+        return;
+#else
+    Q_UNUSED(_signal);
+#endif
+}
+
+MetricsThread::MetricsThread()
+    : thread(nullptr)
+{
+    if(qEnvironmentVariableIntValue("CHECKERS_METRICS_PORT") <= 0 && qEnvironmentVariable("CHECKERS_METRICS_DUMP").isEmpty())
+        return;
+
+    thread = new QThread;
+    auto context = new QObject;
+    context->moveToThread(thread);
+    QObject::connect(thread, &QThread::started, context, [context] { MetricsEndpoint::setupFromEnvironment(context); });
+    QObject::connect(thread, &QThread::finished, context, &QObject::deleteLater);
+    thread->start();
+}
+
+MetricsThread::~MetricsThread()
+{
+    if(!thread)
+        return;
+    thread->quit();
+    thread->wait();
+    delete thread;
+}
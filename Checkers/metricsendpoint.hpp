@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+
+class QTcpServer;
+class QSocketNotifier;
+class QThread;
+
+class MetricsEndpoint : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MetricsEndpoint(QObject *_parent = nullptr);
+    ~MetricsEndpoint() override;
+
+    bool listen(quint16 _port);
+    void dumpOnSignal(const QString &_fileName);
+
+    static void setupFromEnvironment(QObject *_parent);
+
+private slots:
+    void onNewConnection();
+    void onSignalReceived();
+
+private:
+    static void signalHandler(int _signal);
+
+private:
+    QTcpServer *server;
+    QSocketNotifier *signalNotifier;
+    QString dumpFileName;
+};
+
+// Runs the endpoint configured in the environment on a thread of its own, for the headless tools
+// whose main thread never returns to an event loop. The thread stops when this goes out of scope.
+class MetricsThread
+{
+public:
+    MetricsThread();
+    ~MetricsThread();
+
+    MetricsThread(const MetricsThread&) = delete;
+    MetricsThread& operator=(const MetricsThread&) = delete;
+
+private:
+    QThread *thread;
+};
@@ -0,0 +1,136 @@
+#include "moveanimator.hpp"
+#include "cell.hpp"
+#include "trace.hpp"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScreen>
+#include <QWindow>
+
+MoveAnimator::MoveAnimator(QWidget *_parent)
+    : QWidget(_parent)
+    , stepDuration(180)
+{
+    // The overlay repaints its whole dirty rectangle from the cached board snapshot,
+    // so the Cells underneath are never asked to repaint during a frame.
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    hide();
+
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&frameTimer, &QTimer::timeout, this, &MoveAnimator::onFrame);
+}
+
+void MoveAnimator::setStepDuration(int _ms)
+{
+    stepDuration = qMax(1, _ms);
+}
+
+bool MoveAnimator::isRunning() const
+{
+    return frameTimer.isActive();
+}
+
+void MoveAnimator::animate(const QVector<QRect> &_path, const QPixmap &_sprite, const QVector<Capture> &_captures, Cell *_destination)
+{
+    TRACE_SPAN("MoveAnimator::animate");
+    finish();
+    if(_path.size() < 2)
+        return;
+
+    path = _path;
+    sprite = _sprite.scaled(_path.first().size());
+    captures = _captures;
+    destination = _destination;
+    for (auto& capture : captures)
+        capture.sprite = capture.sprite.scaled(capture.rect.size());
+
+    // The static layer is rendered once per move: the destination hides its checker
+    // while the sprite travels, captured checkers are already gone from the board.
+    if(destination)
+        destination->setCheckerHidden(true);
+    setGeometry(parentWidget()->rect());
+    background = parentWidget()->grab();
+
+    const auto screen = window()->windowHandle() ? window()->windowHandle()->screen() : nullptr;
+    const auto refreshRate = screen ? screen->refreshRate() : 60.0;
+    frameTimer.setInterval(qMax(1, qRound(1000.0 / (refreshRate > 0 ? refreshRate : 60.0))));
+
+    lastSpriteRect = spriteRect(0);
+    clock.start();
+    raise();
+    show();
+    frameTimer.start();
+}
+
+void MoveAnimator::finish()
+{
+    if(!frameTimer.isActive() && isHidden())
+        return;
+
+    frameTimer.stop();
+    hide();
+    background = QPixmap();
+    captures.clear();
+    if(destination) {
+        destination->setCheckerHidden(false);
+        destination->update();
+    }
+    destination.clear();
+}
+
+qreal MoveAnimator::progress() const
+{
+    const auto total = qreal(stepDuration) * (path.size() - 1);
+    return qMin<qreal>(1.0, clock.elapsed() / total);
+}
+
+QRect MoveAnimator::spriteRect(qreal _progress) const
+{
+    const auto steps = path.size() - 1;
+    const auto position = _progress * steps;
+    const auto step = qMin(int(position), steps - 1);
+    const auto t = position - step;
+
+    const auto& from = path[step];
+    const auto& to = path[step + 1];
+    const QPointF topLeft = QPointF(from.topLeft()) + (QPointF(to.topLeft()) - QPointF(from.topLeft())) * t;
+    return QRect(topLeft.toPoint(), from.size());
+}
+
+void MoveAnimator::onFrame()
+{
+    TRACE_SPAN("MoveAnimator::onFrame");
+    const auto current = progress();
+    const auto rect = spriteRect(current);
+
+    QRegion dirty(lastSpriteRect.united(rect));
+    for (const auto& capture : captures)
+        dirty += capture.rect;
+    update(dirty);
+    lastSpriteRect = rect;
+
+    if(current >= 1.0)
+        finish();
+}
+
+void MoveAnimator::paintEvent(QPaintEvent *_event)
+{
+    TRACE_SPAN("MoveAnimator::paintEvent");
+    QPainter painter(this);
+    const auto ratio = background.devicePixelRatio();
+    for (const auto& rect : _event->region()) {
+        const QRectF source(rect.x() * ratio, rect.y() * ratio, rect.width() * ratio, rect.height() * ratio);
+        painter.drawPixmap(QRectF(rect), background, source);
+    }
+
+    const auto current = progress();
+    painter.save();
+    painter.setOpacity(1.0 - current);
+    for (const auto& capture : captures)
+        painter.drawPixmap(capture.rect, capture.sprite);
+    painter.restore();
+
+    painter.drawPixmap(spriteRect(current), sprite);
+}
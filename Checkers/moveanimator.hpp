@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QPixmap>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class Cell;
+
+class MoveAnimator : public QWidget
+{
+    Q_OBJECT
+public:
+    struct Capture
+    {
+        QRect rect;
+        QPixmap sprite;
+    };
+
+    explicit MoveAnimator(QWidget *_parent);
+
+    void animate(const QVector<QRect> &_path, const QPixmap &_sprite, const QVector<Capture> &_captures, Cell *_destination);
+    void finish();
+    bool isRunning() const;
+
+    void setStepDuration(int _ms);
+
+protected:
+    void paintEvent(QPaintEvent *_event) override;
+
+private slots:
+    void onFrame();
+
+private:
+    QRect spriteRect(qreal _progress) const;
+    qreal progress() const;
+
+private:
+    QTimer frameTimer;
+    QElapsedTimer clock;
+    QPixmap background;
+    QPixmap sprite;
+    QVector<QRect> path;
+    QVector<Capture> captures;
+    QPointer<Cell> destination;
+    QRect lastSpriteRect;
+    int stepDuration;
+};
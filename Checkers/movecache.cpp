@@ -0,0 +1,73 @@
+#include "movecache.hpp"
+#include "cell.hpp"
+#include "king.hpp"
+#include "zobrist.hpp"
+
+bool MoveCache::Entry::isEmpty() const
+{
+    return moves.isEmpty() && jumps.isEmpty();
+}
+
+MoveCache::MoveCache(const int _capacity)
+    : capacity(_capacity)
+{
+    entries.reserve(_capacity);
+}
+
+quint64 MoveCache::positionHash(const board_t &_cells, const Type _sideToMove)
+{
+    quint64 hash = _sideToMove == Type::Black ? Zobrist::sideKey() : 0;
+
+    int square = 0;
+    for (const auto& row : _cells) {
+        for (const auto& cell : row) {
+            const auto& checker = cell->getChecker();
+            if(checker) {
+                const bool isKing = dynamic_cast<King*>(checker.get()) != nullptr;
+                Zobrist::Piece piece;
+                if(checker->getType() == Type::White)
+                    piece = isKing ? Zobrist::Piece::WhiteKing : Zobrist::Piece::WhiteMan;
+                else
+                    piece = isKing ? Zobrist::Piece::BlackKing : Zobrist::Piece::BlackMan;
+                hash ^= Zobrist::pieceKey(square, piece);
+            }
+            ++square;
+        }
+    }
+    return hash;
+}
+
+quint64 MoveCache::continuationHash(const quint64 _positionHash, const index_t &_origin)
+{
+    // A multi-jump continuation is keyed apart from the plain position: only the jumping checker may move.
+    const auto salt = (static_cast<quint64>(_origin.first) << 32) | static_cast<quint32>(_origin.second);
+    return _positionHash ^ ((salt + 1) * 0xC2B2AE3D27D4EB4Full);
+}
+
+bool MoveCache::contains(const quint64 _key) const
+{
+    return entries.contains(_key);
+}
+
+MoveCache::Entry MoveCache::value(const quint64 _key) const
+{
+    return entries.value(_key);
+}
+
+void MoveCache::insert(const quint64 _key, const Entry &_entry)
+{
+    if(entries.contains(_key))
+        return;
+
+    while(entries.size() >= capacity && !insertionOrder.isEmpty())
+        entries.remove(insertionOrder.dequeue());
+
+    entries.insert(_key, _entry);
+    insertionOrder.enqueue(_key);
+}
+
+void MoveCache::clear()
+{
+    entries.clear();
+    insertionOrder.clear();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "checker.hpp"
+
+#include <QHash>
+#include <QQueue>
+#include <QVector>
+
+class MoveCache
+{
+public:
+    using index_t = Checker::index_t;
+    using board_t = Checker::board_t;
+    using Type = Checker::Type;
+
+    struct Entry {
+        QHash<index_t, QVector<index_t>> moves;
+        QHash<index_t, QVector<Checker::JumpData>> jumps;
+
+        bool isEmpty() const;
+    };
+
+    explicit MoveCache(const int _capacity = 1024);
+
+    static quint64 positionHash(const board_t &_cells, const Type _sideToMove);
+    static quint64 continuationHash(const quint64 _positionHash, const index_t &_origin);
+
+    bool contains(const quint64 _key) const;
+    Entry value(const quint64 _key) const;
+    void insert(const quint64 _key, const Entry &_entry);
+    void clear();
+
+private:
+    QHash<quint64, Entry> entries;
+    QQueue<quint64> insertionOrder;
+    const int capacity;
+};
@@ -0,0 +1,250 @@
+#include "pnsolver.hpp"
+
+#include <algorithm>
+
+PnSolver::PnSolver(const Limits &_limits)
+    : limits(_limits)
+    , attacker(Position::Side::White)
+    , drawIsSuccess(false)
+    , horizonReached(false)
+    , nodes(0)
+    , outOfBudget(false)
+{
+    const auto bytes = static_cast<size_t>(std::max(limits.memoryMegabytes, 1)) * 1024 * 1024;
+    size_t entries = 1;
+    while(entries * 2 * sizeof(Entry) <= bytes)
+        entries *= 2;
+    table.resize(entries);
+}
+
+const char* PnSolver::outcomeName(const Outcome _outcome)
+{
+    switch (_outcome) {
+    case Outcome::Won: return "won";
+    case Outcome::Lost: return "lost";
+    case Outcome::Drawn: return "drawn";
+    case Outcome::Undecided: return "undecided";
+    case Outcome::Unknown: break;
+    }
+    return "unknown";
+}
+
+PnSolver::Result PnSolver::solve(const Position &_root)
+{
+    Result result;
+
+    // First ask "does the side to move win?", then "does it at least avoid losing?". Each proof
+    // gets the full node budget. The horizon counts against the prover in the first and for it
+    // in the second, so a win or a loss is exact; a draw is only exact if neither proof reached it.
+    const auto win = prove(_root, false);
+    const bool winAtHorizon = horizonReached;
+    result.nodes = nodes;
+    if(win == Proof::Proven) {
+        result.outcome = Outcome::Won;
+        result.hasMove = findMove(_root, result.bestMove);
+    }
+    else if(win == Proof::Disproven) {
+        const auto hold = prove(_root, true);
+        result.nodes += nodes;
+        if(hold == Proof::Disproven) {
+            result.outcome = Outcome::Lost;
+        }
+        else if(hold == Proof::Proven) {
+            result.outcome = winAtHorizon || horizonReached ? Outcome::Undecided : Outcome::Drawn;
+            result.hasMove = findMove(_root, result.bestMove);
+        }
+    }
+    return result;
+}
+
+PnSolver::Proof PnSolver::prove(const Position &_root, bool _drawIsSuccess)
+{
+    std::fill(table.begin(), table.end(), Entry());
+    attacker = _root.sideToMove();
+    drawIsSuccess = _drawIsSuccess;
+    horizonReached = false;
+    nodes = 0;
+    outOfBudget = false;
+    path.reset(_root);
+
+    mid(_root, limits.maxPlies, infinity - 1, infinity - 1);
+    if(outOfBudget)
+        return Proof::Unknown;
+
+    quint32 phi, delta;
+    lookup(keyOf(_root, limits.maxPlies), phi, delta);
+    if(phi != 0 && delta != 0)
+        return Proof::Unknown;
+    return phi == 0 ? Proof::Proven : Proof::Disproven;
+}
+
+// A proven OR root has a child whose delta is zero; that child is the move to play. Its entry
+// may have been overwritten in the table since, in which case no move is reported.
+bool PnSolver::findMove(const Position &_root, Position::Move &_move)
+{
+    Position::MoveList moves;
+    _root.generateMoves(moves);
+    for (const auto& move : moves) {
+        const auto child = _root.play(move);
+        quint32 childPhi, childDelta;
+        path.push(_root, child);
+        if(!terminal(child, limits.maxPlies - 1, child.hasMoves(), childPhi, childDelta))
+            lookup(keyOf(child, limits.maxPlies - 1), childPhi, childDelta);
+        path.pop();
+        if(childDelta == 0) {
+            _move = move;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PnSolver::terminal(const Position &_position, int _remaining, bool _hasMoves, quint32 &_phi, quint32 &_delta)
+{
+    bool success;
+    if(!_hasMoves) {
+        success = _position.sideToMove() != attacker;
+    }
+    else if(path.isDraw()) {
+        success = drawIsSuccess;
+    }
+    else if(_remaining <= 0) {
+        success = drawIsSuccess;
+        horizonReached = true;
+    }
+    else {
+        return false;
+    }
+
+    // phi/delta are from the point of view of the side to move.
+    const bool moverSucceeds = (_position.sideToMove() == attacker) == success;
+    _phi = moverSucceeds ? 0 : infinity;
+    _delta = moverSucceeds ? infinity : 0;
+    return true;
+}
+
+void PnSolver::mid(const Position &_position, int _remaining, quint32 _thresholdPhi, quint32 _thresholdDelta)
+{
+    ++nodes;
+    if(nodes >= limits.nodes) {
+        outOfBudget = true;
+        return;
+    }
+
+    const auto key = keyOf(_position, _remaining);
+    Position::MoveList moves;
+    _position.generateMoves(moves);
+
+    quint32 phi, delta;
+    if(terminal(_position, _remaining, !moves.empty(), phi, delta)) {
+        store(key, phi, delta);
+        return;
+    }
+
+    struct Child
+    {
+        Position position;
+        quint64 key;
+        bool terminal;
+        quint32 phi;
+        quint32 delta;
+    };
+
+    std::vector<Child> children;
+    children.reserve(moves.size());
+    for (const auto& move : moves) {
+        Child child;
+        child.position = _position.play(move);
+        path.push(_position, child.position);
+        child.key = keyOf(child.position, _remaining - 1);
+        child.terminal = terminal(child.position, _remaining - 1, child.position.hasMoves(), child.phi, child.delta);
+        path.pop();
+        children.push_back(child);
+    }
+
+    while(true) {
+        // phi(n) = min delta(child), delta(n) = sum phi(child).
+        quint32 minDelta = infinity, secondDelta = infinity, sumPhi = 0;
+        quint32 bestPhi = infinity;
+        size_t best = 0;
+        for (size_t i = 0; i < children.size(); ++i) {
+            auto& child = children[i];
+            if(!child.terminal)
+                lookup(child.key, child.phi, child.delta);
+
+            sumPhi = add(sumPhi, child.phi);
+            if(child.delta < minDelta) {
+                secondDelta = minDelta;
+                minDelta = child.delta;
+                bestPhi = child.phi;
+                best = i;
+            }
+            else if(child.delta < secondDelta) {
+                secondDelta = child.delta;
+            }
+        }
+
+        phi = minDelta;
+        delta = sumPhi;
+        if(phi >= _thresholdPhi || delta >= _thresholdDelta) {
+            store(key, phi, delta);
+            return;
+        }
+
+        const auto childThresholdPhi = std::min(add(_thresholdDelta - delta, bestPhi), infinity - 1);
+        const auto childThresholdDelta = std::min(_thresholdPhi, add(secondDelta, 1));
+        path.push(_position, children[best].position);
+        mid(children[best].position, _remaining - 1, childThresholdPhi, childThresholdDelta);
+        path.pop();
+        if(outOfBudget) {
+            store(key, phi, delta);
+            return;
+        }
+    }
+}
+
+quint64 PnSolver::keyOf(const Position &_position, int _remaining) const
+{
+    // The remaining horizon and the quiet-move count are part of the key: the same position closer
+    // to the horizon or to the move limit is a different node. Repetitions depend on the line and
+    // are not, so a result stored under a repetition draw can be reused on another line.
+    const auto salt = static_cast<quint64>(_remaining + 1) * 0x9E3779B97F4A7C15ull
+            + static_cast<quint64>(path.quietPlies()) * 0xC2B2AE3D27D4EB4Full;
+    return _position.hash() ^ salt;
+}
+
+void PnSolver::lookup(quint64 _key, quint32 &_phi, quint32 &_delta) const
+{
+    const auto slot = _key & (table.size() - 1);
+    for (const auto index : { slot, slot ^ 1 }) {
+        const auto& entry = table[index];
+        if(entry.key == _key) {
+            _phi = entry.phi;
+            _delta = entry.delta;
+            return;
+        }
+    }
+    _phi = 1;
+    _delta = 1;
+}
+
+void PnSolver::store(quint64 _key, quint32 _phi, quint32 _delta)
+{
+    // Two entries per key: solved entries are the expensive ones to lose, so the other one is
+    // replaced first. A store is never dropped, since mid() relies on reading back what it stored.
+    const auto slot = _key & (table.size() - 1);
+    auto isSolved = [](const Entry &_entry) { return _entry.phi == 0 || _entry.delta == 0; };
+    auto* entry = &table[slot];
+    auto& other = table[slot ^ 1];
+    if(other.key == _key || (entry->key != _key && isSolved(*entry) && !isSolved(other)))
+        entry = &other;
+    entry->key = _key;
+    entry->phi = _phi;
+    entry->delta = _delta;
+}
+
+quint32 PnSolver::add(quint32 _a, quint32 _b)
+{
+    const auto sum = static_cast<quint64>(_a) + _b;
+    return sum >= infinity ? infinity : static_cast<quint32>(sum);
+}
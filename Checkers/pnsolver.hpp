@@ -0,0 +1,75 @@
+#pragma once
+
+#include "gamehistory.hpp"
+
+#include <vector>
+
+// Depth-first proof-number search (df-pn). Only the draw rules of the game, a repetition on the
+// line or the quiet-move limit, prove a draw; a line still open after maxPlies makes the result
+// Undecided, and Unknown means the node budget ran out first.
+class PnSolver
+{
+public:
+    enum class Outcome { Won, Lost, Drawn, Undecided, Unknown };
+
+#ifdef CHECKERS_LOW_MEMORY
+    static constexpr int defaultMemoryMegabytes = 4;
+#else
+    static constexpr int defaultMemoryMegabytes = 64;
+#endif
+
+    struct Limits
+    {
+        int memoryMegabytes = defaultMemoryMegabytes;
+        quint64 nodes = 10000000;
+        int maxPlies = 80;
+    };
+
+    struct Result
+    {
+        Outcome outcome = Outcome::Unknown;
+        quint64 nodes = 0;
+        bool hasMove = false;
+        Position::Move bestMove;
+    };
+
+    explicit PnSolver(const Limits &_limits);
+
+    Result solve(const Position &_root);
+
+    static const char* outcomeName(const Outcome _outcome);
+
+private:
+    static constexpr quint32 infinity = 100000000;
+
+    enum class Proof { Proven, Disproven, Unknown };
+
+    struct Entry
+    {
+        quint64 key = 0;
+        quint32 phi = 1;
+        quint32 delta = 1;
+    };
+
+    Proof prove(const Position &_root, bool _drawIsSuccess);
+    bool findMove(const Position &_root, Position::Move &_move);
+    void mid(const Position &_position, int _remaining, quint32 _thresholdPhi, quint32 _thresholdDelta);
+    // For both, _position is the last position of path.
+    bool terminal(const Position &_position, int _remaining, bool _hasMoves, quint32 &_phi, quint32 &_delta);
+    quint64 keyOf(const Position &_position, int _remaining) const;
+
+    void lookup(quint64 _key, quint32 &_phi, quint32 &_delta) const;
+    void store(quint64 _key, quint32 _phi, quint32 _delta);
+
+    static quint32 add(quint32 _a, quint32 _b);
+
+private:
+    Limits limits;
+    std::vector<Entry> table;
+    SearchPath path;
+    Position::Side attacker;
+    bool drawIsSuccess;
+    bool horizonReached;
+    quint64 nodes;
+    bool outOfBudget;
+};
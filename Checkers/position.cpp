@@ -0,0 +1,419 @@
+#include "position.hpp"
+#include "zobrist.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+struct Geometry
+{
+    explicit Geometry(const int _edge)
+    {
+        const int cols = _edge / 2;
+        for (auto& direction : neighbours)
+            direction.fill(-1);
+
+        for (int row = 0; row < _edge; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                // Same arithmetic as Checker::getTopLeft() and friends.
+                const int left = (row % 2) != 0 ? col - 1 : col;
+                const int right = (row % 2) != 0 ? col : col + 1;
+                const int square = row * cols + col;
+                auto link = [&](Position::Direction _direction, int _row, int _col) {
+                    if(_row >= 0 && _row < _edge && _col >= 0 && _col < cols)
+                        neighbours[static_cast<int>(_direction)][square] = static_cast<qint8>(_row * cols + _col);
+                };
+                link(Position::Direction::TopLeft, row - 1, left);
+                link(Position::Direction::TopRight, row - 1, right);
+                link(Position::Direction::BottomLeft, row + 1, left);
+                link(Position::Direction::BottomRight, row + 1, right);
+            }
+        }
+    }
+
+    std::array<std::array<qint8, Position::maxSquares>, 4> neighbours;
+};
+
+const Geometry& geometry(const int _edge)
+{
+    static const Geometry eight(8);
+    static const Geometry ten(10);
+    return _edge == 10 ? ten : eight;
+}
+
+const Position::Direction allDirections[] = {
+    Position::Direction::TopLeft, Position::Direction::TopRight,
+    Position::Direction::BottomLeft, Position::Direction::BottomRight
+};
+
+int lowestSquare(quint64 _mask)
+{
+    int square = 0;
+    while(!(_mask & 1)) {
+        _mask >>= 1;
+        ++square;
+    }
+    return square;
+}
+
+int popCount(quint64 _mask)
+{
+    int count = 0;
+    for (; _mask; _mask &= _mask - 1)
+        ++count;
+    return count;
+}
+
+bool isForward(const Position::Direction _direction, const Position::Side _side)
+{
+    const bool upwards = _direction == Position::Direction::TopLeft || _direction == Position::Direction::TopRight;
+    return upwards == (_side == Position::Side::White);
+}
+
+// The rule checks below test Rules<V> constants, so each instantiation keeps only its own branches.
+template<Variant V>
+class MoveGenerator
+{
+    using R = Rules<V>;
+
+public:
+    explicit MoveGenerator(const Position &_position)
+        : position(_position)
+        , side(_position.sideToMove())
+        , enemies(_position.pieces(Position::opponent(side)))
+        , occupied(_position.occupied())
+    {}
+
+    void generate(Position::MoveList &_moves)
+    {
+        for (auto mask = position.pieces(side); mask; mask &= mask - 1) {
+            const int square = lowestSquare(mask);
+            Position::Move move;
+            move.from = static_cast<quint8>(square);
+            extendCapture(square, position.isKing(square), move, _moves);
+        }
+
+        if(!_moves.empty())
+            return;
+        generateQuietMoves(_moves);
+    }
+
+private:
+    void extendCapture(const int _square, const bool _king, Position::Move &_move, Position::MoveList &_moves)
+    {
+        const auto targets = enemies & ~_move.captured;
+        // Either captured pieces stay on the board until the move ends, or they vanish at once.
+        const auto blocked = (R::capturedPiecesBlock ? occupied : occupied & ~_move.captured) & ~Position::bit(_move.from);
+        const bool flying = _king && R::flyingKings;
+
+        bool extended = false;
+        if(_move.length < Position::maxPath) {
+            for (auto direction : allDirections) {
+                if(!_king && !R::menCaptureBackward && !isForward(direction, side))
+                    continue;
+
+                int over = position.neighbour(_square, direction);
+                while(flying && over >= 0 && !(blocked & Position::bit(over)))
+                    over = position.neighbour(over, direction);
+                if(over < 0 || !(targets & Position::bit(over)))
+                    continue;
+
+                for (int landing = position.neighbour(over, direction); landing >= 0 && !(blocked & Position::bit(landing));
+                     landing = position.neighbour(landing, direction)) {
+                    _move.path[_move.length++] = static_cast<quint8>(landing);
+                    _move.captured |= Position::bit(over);
+
+                    const bool promoted = !_king && position.isPromotionSquare(landing, side);
+                    if(promoted && R::promotion == Promotion::EndsCapture)
+                        record(landing, _move, _moves);
+                    else
+                        extendCapture(landing, _king || (promoted && R::promotion == Promotion::ContinueAsKing), _move, _moves);
+
+                    _move.captured &= ~Position::bit(over);
+                    --_move.length;
+                    extended = true;
+                    if(!flying)
+                        break;
+                }
+            }
+        }
+
+        if(!extended && _move.length > 0)
+            record(_square, _move, _moves);
+    }
+
+    // Under the majority rule only the longest captures are kept, and shorter ones never take
+    // room in the list: flying kings can produce more short captures than the list holds.
+    void record(const int _square, Position::Move &_move, Position::MoveList &_moves)
+    {
+        if(R::capture == CaptureRule::Majority) {
+            const int count = popCount(_move.captured);
+            if(count < longest)
+                return;
+            if(count > longest) {
+                longest = count;
+                _moves.clear();
+            }
+        }
+        _move.to = static_cast<quint8>(_square);
+        _moves.push(_move);
+    }
+
+    void generateQuietMoves(Position::MoveList &_moves) const
+    {
+        for (auto mask = position.pieces(side); mask; mask &= mask - 1) {
+            const int square = lowestSquare(mask);
+            const bool king = position.isKing(square);
+            for (auto direction : allDirections) {
+                if(!king && !isForward(direction, side))
+                    continue;
+
+                for (int target = position.neighbour(square, direction); target >= 0 && !(occupied & Position::bit(target));
+                     target = position.neighbour(target, direction)) {
+                    Position::Move move;
+                    move.from = static_cast<quint8>(square);
+                    move.to = static_cast<quint8>(target);
+                    move.length = 1;
+                    move.path[0] = move.to;
+                    _moves.push(move);
+                    if(!(king && R::flyingKings))
+                        break;
+                }
+            }
+        }
+    }
+
+private:
+    const Position &position;
+    const Position::Side side;
+    const quint64 enemies;
+    const quint64 occupied;
+    int longest = 0;
+};
+
+}
+
+bool Position::Move::operator==(const Move &_other) const
+{
+    if(from != _other.from || to != _other.to || length != _other.length || captured != _other.captured)
+        return false;
+    for (int i = 0; i < length; ++i) {
+        if(path[i] != _other.path[i])
+            return false;
+    }
+    return true;
+}
+
+Position::Position()
+    : Position(8)
+{}
+
+Position::Position(const int _edge, const Variant _variant)
+    : white(0)
+    , black(0)
+    , kings(0)
+    , edgeSize(static_cast<quint8>(_variant != Variant::Classic ? variantInfo(_variant).edge : (_edge == 10 ? 10 : 8)))
+    , rules(_variant)
+    , side(Side::White)
+{}
+
+Position Position::initial(const Variant _variant)
+{
+    auto position = initial(variantInfo(_variant).edge);
+    position.rules = _variant;
+    return position;
+}
+
+Position Position::initial(const int _edge)
+{
+    Position position(_edge);
+    const int rowsPerPlayer = position.edge() / 2 - 1;
+    const int cols = position.edge() / 2;
+
+    for (int row = 0; row < rowsPerPlayer; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            position.put(position.square(row, col), Side::Black, false);
+            position.put(position.square(position.edge() - 1 - row, col), Side::White, false);
+        }
+    }
+    return position;
+}
+
+int Position::neighbour(const int _square, const Direction _direction) const
+{
+    return geometry(edgeSize).neighbours[static_cast<int>(_direction)][_square];
+}
+
+int Position::capturedBetween(const int _from, const int _to, const quint64 _captured) const
+{
+    for (auto direction : allDirections) {
+        int victim = -1;
+        for (int square = neighbour(_from, direction); square >= 0; square = neighbour(square, direction)) {
+            if(square == _to)
+                return victim;
+            if(_captured & bit(square))
+                victim = square;
+        }
+    }
+    return -1;
+}
+
+void Position::put(const int _square, const Side _side, const bool _king)
+{
+    clear(_square);
+    (_side == Side::White ? white : black) |= bit(_square);
+    if(_king)
+        kings |= bit(_square);
+}
+
+void Position::clear(const int _square)
+{
+    const auto mask = ~bit(_square);
+    white &= mask;
+    black &= mask;
+    kings &= mask;
+}
+
+quint64 Position::hash() const
+{
+    quint64 result = side == Side::Black ? Zobrist::sideKey() : 0;
+    for (auto mask = occupied(); mask; mask &= mask - 1) {
+        const int square = lowestSquare(mask);
+        const bool king = isKing(square);
+        Zobrist::Piece piece;
+        if(white & bit(square))
+            piece = king ? Zobrist::Piece::WhiteKing : Zobrist::Piece::WhiteMan;
+        else
+            piece = king ? Zobrist::Piece::BlackKing : Zobrist::Piece::BlackMan;
+        result ^= Zobrist::pieceKey(square, piece);
+    }
+    return result;
+}
+
+void Position::generateMoves(MoveList &_moves) const
+{
+    _moves.clear();
+    // One dispatch per call; everything below it is specialized for the variant's rules.
+    switch (rules) {
+    case Variant::Classic: MoveGenerator<Variant::Classic>(*this).generate(_moves); break;
+    case Variant::American: MoveGenerator<Variant::American>(*this).generate(_moves); break;
+    case Variant::Russian: MoveGenerator<Variant::Russian>(*this).generate(_moves); break;
+    case Variant::Brazilian: MoveGenerator<Variant::Brazilian>(*this).generate(_moves); break;
+    case Variant::International: MoveGenerator<Variant::International>(*this).generate(_moves); break;
+    case Variant::Pool: MoveGenerator<Variant::Pool>(*this).generate(_moves); break;
+    }
+}
+
+bool Position::hasMoves() const
+{
+    MoveList moves;
+    generateMoves(moves);
+    return !moves.empty();
+}
+
+bool Position::isPromotionSquare(const int _square, const Side _side) const
+{
+    return _side == Side::White ? row(_square) == 0 : row(_square) == edgeSize - 1;
+}
+
+Position Position::play(const Move &_move) const
+{
+    Position next(*this);
+    const auto promotion = variantInfo(rules).promotion;
+    bool king = isKing(_move.from) || (promotion != Promotion::None && isPromotionSquare(_move.to, side));
+    if(!king && _move.isCapture() && promotion == Promotion::ContinueAsKing) {
+        for (int i = 0; i < _move.length && !king; ++i)
+            king = isPromotionSquare(_move.path[i], side);
+    }
+
+    next.clear(_move.from);
+    for (auto mask = _move.captured; mask; mask &= mask - 1)
+        next.clear(lowestSquare(mask));
+    next.put(_move.to, side, king);
+    next.side = opponent(side);
+    return next;
+}
+
+std::string Position::moveToString(const Move &_move) const
+{
+    const char separator = _move.isCapture() ? 'x' : '-';
+    std::string text = std::to_string(_move.from + 1);
+    for (int i = 0; i < _move.length; ++i) {
+        text += separator;
+        text += std::to_string(_move.path[i] + 1);
+    }
+    return text;
+}
+
+bool Position::parseMove(const std::string &_text, Move &_move) const
+{
+    // Accept both the full path and the short "from-to" / "fromxto" form.
+    MoveList moves;
+    generateMoves(moves);
+
+    for (const auto& move : moves) {
+        const auto full = moveToString(move);
+        const char separator = move.isCapture() ? 'x' : '-';
+        const auto shortForm = std::to_string(move.from + 1) + separator + std::to_string(move.to + 1);
+        if(_text == full || _text == shortForm) {
+            _move = move;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string Position::toFen() const
+{
+    std::string fen(side == Side::White ? "W" : "B");
+    for (auto player : { Side::White, Side::Black }) {
+        fen += player == Side::White ? ":W" : ":B";
+        bool first = true;
+        for (auto mask = pieces(player); mask; mask &= mask - 1) {
+            const int square = lowestSquare(mask);
+            if(!first)
+                fen += ',';
+            first = false;
+            if(isKing(square))
+                fen += 'K';
+            fen += std::to_string(square + 1);
+        }
+    }
+    return fen;
+}
+
+bool Position::fromFen(const std::string &_fen, Position &_position, const int _edge, const Variant _variant)
+{
+    Position result(_edge, _variant);
+    std::stringstream stream(_fen);
+    std::string field;
+
+    if(!std::getline(stream, field, ':') || field.size() != 1 || (field[0] != 'W' && field[0] != 'B'))
+        return false;
+    result.side = field[0] == 'W' ? Side::White : Side::Black;
+
+    while(std::getline(stream, field, ':')) {
+        if(field.empty() || (field[0] != 'W' && field[0] != 'B'))
+            return false;
+        const auto player = field[0] == 'W' ? Side::White : Side::Black;
+
+        std::stringstream squares(field.substr(1));
+        std::string item;
+        while(std::getline(squares, item, ',')) {
+            const bool king = !item.empty() && item[0] == 'K';
+            if(king)
+                item.erase(0, 1);
+            // No board has more than 50 squares; longer numbers would overflow std::stoi.
+            if(item.empty() || item.size() > 3 || item.find_first_not_of("0123456789") != std::string::npos)
+                return false;
+            const int square = std::stoi(item) - 1;
+            if(square < 0 || square >= result.squareCount())
+                return false;
+            result.put(square, player, king);
+        }
+    }
+
+    _position = result;
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "variant.hpp"
+
+#include <QtGlobal>
+
+#include <array>
+#include <string>
+
+// Compact, widget-free game state sharing the board geometry of Checker/Cell:
+// squares are numbered row by row from the top, edge / 2 playable squares per row.
+class Position
+{
+public:
+    enum class Side : quint8 { White, Black };
+    enum class Direction { TopLeft, TopRight, BottomLeft, BottomRight };
+
+    static constexpr int maxEdge = 10;
+    static constexpr int maxSquares = maxEdge * maxEdge / 2;
+    static constexpr int maxPath = 24;
+    static constexpr int maxMoves = 128;
+
+    struct Move
+    {
+        quint8 from = 0;
+        quint8 to = 0;
+        quint8 length = 0;
+        std::array<quint8, maxPath> path {};
+        quint64 captured = 0;
+
+        bool isCapture() const { return captured != 0; }
+        bool operator==(const Move &_other) const;
+        bool operator!=(const Move &_other) const { return !(*this == _other); }
+    };
+
+    class MoveList
+    {
+    public:
+        void clear() { count = 0; }
+        void push(const Move &_move)
+        {
+            Q_ASSERT_X(count < maxMoves, "Position::MoveList::push", "more legal moves than maxMoves");
+            if(count < maxMoves)
+                moves[count++] = _move;
+        }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        const Move& operator[](int _index) const { return moves[_index]; }
+        const Move* begin() const { return moves.data(); }
+        const Move* end() const { return moves.data() + count; }
+
+    private:
+        std::array<Move, maxMoves> moves;
+        int count = 0;
+    };
+
+    Position();
+    // Classic, the original widget game, is played on 8x8 or 10x10; every other variant has
+    // the edge of its rules and _edge is ignored for it.
+    explicit Position(const int _edge, const Variant _variant = Variant::Classic);
+
+    static Position initial(const int _edge = 8);
+    static Position initial(const Variant _variant);
+    // _edge is only used for Classic, as in the constructor.
+    static bool fromFen(const std::string &_fen, Position &_position, const int _edge = 8, const Variant _variant = Variant::Classic);
+    std::string toFen() const;
+
+    int edge() const { return edgeSize; }
+    Variant variant() const { return rules; }
+    int squareCount() const { return edgeSize * edgeSize / 2; }
+    int square(const int _row, const int _col) const { return _row * (edgeSize / 2) + _col; }
+    int row(const int _square) const { return _square / (edgeSize / 2); }
+    int col(const int _square) const { return _square % (edgeSize / 2); }
+    int neighbour(const int _square, const Direction _direction) const;
+    int capturedBetween(const int _from, const int _to, const quint64 _captured) const;
+
+    Side sideToMove() const { return side; }
+    void setSideToMove(const Side _side) { side = _side; }
+    quint64 pieces(const Side _side) const { return _side == Side::White ? white : black; }
+    quint64 kingMask() const { return kings; }
+    quint64 occupied() const { return white | black; }
+    bool isKing(const int _square) const { return kings & bit(_square); }
+    void put(const int _square, const Side _side, const bool _king);
+    void clear(const int _square);
+
+    quint64 hash() const;
+
+    void generateMoves(MoveList &_moves) const;
+    bool hasMoves() const;
+    Position play(const Move &_move) const;
+
+    std::string moveToString(const Move &_move) const;
+    bool parseMove(const std::string &_text, Move &_move) const;
+
+    static quint64 bit(const int _square) { return quint64(1) << _square; }
+    static Side opponent(const Side _side) { return _side == Side::White ? Side::Black : Side::White; }
+
+    bool isPromotionSquare(const int _square, const Side _side) const;
+
+private:
+    quint64 white;
+    quint64 black;
+    quint64 kings;
+    quint8 edgeSize;
+    Variant rules;
+    Side side;
+};
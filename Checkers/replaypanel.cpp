@@ -0,0 +1,109 @@
+#include "replaypanel.hpp"
+#include "trace.hpp"
+
+#include <QComboBox>
+#include <QFile>
+#include <QLabel>
+#include <QSlider>
+#include <QVBoxLayout>
+
+ReplayPanel::ReplayPanel(const int _boardEdgeSize, const Variant _variant, QWidget *_parent)
+    : QWidget(_parent)
+    , gameList(new QComboBox(this))
+    , slider(new QSlider(Qt::Horizontal, this))
+    , status(new QLabel(this))
+    , boardEdgeSize(_boardEdgeSize)
+    , variant(_variant)
+{
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(gameList);
+    layout->addWidget(slider);
+    layout->addWidget(status);
+    layout->addStretch();
+
+    slider->setEnabled(false);
+    slider->setPageStep(GameReplay::defaultKeyframeInterval);
+
+    connect(gameList, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ReplayPanel::selectGame);
+    connect(slider, &QSlider::valueChanged, this, &ReplayPanel::seek);
+}
+
+bool ReplayPanel::loadArchive(const QString &_fileName, QString *_error)
+{
+    QFile file(_fileName);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if(_error)
+            *_error = file.errorString();
+        return false;
+    }
+
+    std::vector<GameRecord> loaded;
+    std::string error;
+    if(!GameArchive::parse(file.readAll().toStdString(), loaded, &error, boardEdgeSize, variant) || loaded.empty()) {
+        if(_error)
+            *_error = loaded.empty() && error.empty() ? tr("No games found") : QString::fromStdString(error);
+        return false;
+    }
+
+    games = std::move(loaded);
+    QSignalBlocker blocker(gameList);
+    gameList->clear();
+    for (size_t i = 0; i < games.size(); ++i) {
+        const auto& record = games[i];
+        auto title = QString::fromStdString(record.tag("White") + " - " + record.tag("Black"));
+        if(record.tag("White").empty() && record.tag("Black").empty())
+            title = QString::fromStdString(record.tag("Event"));
+        gameList->addItem(tr("%1. %2 (%3)").arg(i + 1).arg(title).arg(QString::fromStdString(record.result)));
+    }
+    blocker.unblock();
+    selectGame(0);
+    return true;
+}
+
+const GameRecord &ReplayPanel::game(const int _index) const
+{
+    return games[_index];
+}
+
+int ReplayPanel::gameCount() const
+{
+    return static_cast<int>(games.size());
+}
+
+void ReplayPanel::selectGame(int _index)
+{
+    if(_index < 0 || _index >= gameCount())
+        return;
+
+    const auto& record = games[_index];
+    replay = GameReplay(record.start, record.moves);
+    if(gameList->currentIndex() != _index) {
+        QSignalBlocker blocker(gameList);
+        gameList->setCurrentIndex(_index);
+    }
+
+    emit gameSelected(_index);
+
+    QSignalBlocker blocker(slider);
+    slider->setEnabled(true);
+    slider->setRange(0, replay.plyCount());
+    slider->setValue(0);
+    blocker.unblock();
+    seek(0);
+}
+
+void ReplayPanel::seek(int _ply)
+{
+    TRACE_SPAN("ReplayPanel::seek");
+    updateStatus(_ply);
+    emit positionSelected(replay.positionAt(_ply));
+}
+
+void ReplayPanel::updateStatus(int _ply)
+{
+    const Position geometry(boardEdgeSize);
+    auto text = tr("Ply %1 / %2").arg(_ply).arg(replay.plyCount());
+    if(_ply > 0)
+        text += "  " + QString::fromStdString(geometry.moveToString(replay.move(_ply - 1)));
+    status->setText(text);
+}
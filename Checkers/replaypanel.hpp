@@ -0,0 +1,43 @@
+#pragma once
+
+#include "gamearchive.hpp"
+#include "gamereplay.hpp"
+
+#include <QWidget>
+
+#include <vector>
+
+class QComboBox;
+class QLabel;
+class QSlider;
+
+class ReplayPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ReplayPanel(const int _boardEdgeSize = 8, const Variant _variant = Variant::Classic, QWidget *_parent = nullptr);
+
+    bool loadArchive(const QString &_fileName, QString *_error = nullptr);
+    const GameRecord& game(const int _index) const;
+    int gameCount() const;
+
+public slots:
+    void selectGame(int _index);
+    void seek(int _ply);
+
+signals:
+    void gameSelected(int _index);
+    void positionSelected(const Position &_position);
+
+private:
+    void updateStatus(int _ply);
+
+private:
+    std::vector<GameRecord> games;
+    GameReplay replay;
+    QComboBox *gameList;
+    QSlider *slider;
+    QLabel *status;
+    const int boardEdgeSize;
+    const Variant variant;
+};
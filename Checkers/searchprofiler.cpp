@@ -0,0 +1,92 @@
+#include "searchprofiler.hpp"
+
+#include <iomanip>
+
+namespace {
+const size_t maxSamples = 100000;
+
+double ratio(quint64 _part, quint64 _whole)
+{
+    return _whole ? double(_part) / double(_whole) : 0.0;
+}
+}
+
+SearchProfiler::SearchProfiler(const quint64 _sampleInterval)
+    : sampleInterval(_sampleInterval ? _sampleInterval : 1)
+{
+    reset();
+}
+
+void SearchProfiler::reset()
+{
+    plies.fill(PlyStats());
+    samples.clear();
+    sampleCounter = 0;
+    ttMisses = 0;
+    ttHits = 0;
+    ttCollisions = 0;
+    moveGenerationNs = 0;
+    evaluationNs = 0;
+}
+
+void SearchProfiler::cutoff(int _ply, int _moveNumber)
+{
+    auto& stats = plies[clampPly(_ply)];
+    ++stats.cutoffs;
+    if(_moveNumber == 0)
+        ++stats.firstMoveCutoffs;
+}
+
+void SearchProfiler::probe(Probe _result)
+{
+    switch (_result) {
+    case Probe::Miss: ++ttMisses; break;
+    case Probe::Hit: ++ttHits; break;
+    case Probe::Collision: ++ttCollisions; break;
+    }
+}
+
+void SearchProfiler::sample(int _ply, int _depth, int _alpha, int _beta, int _score, quint64 _key)
+{
+    if(++sampleCounter % sampleInterval != 0 || samples.size() >= maxSamples)
+        return;
+    samples.push_back({ _ply, _depth, _alpha, _beta, _score, _key });
+}
+
+void SearchProfiler::report(std::ostream &_out, qint64 _searchNs) const
+{
+    quint64 totalNodes = 0;
+    for (const auto& stats : plies)
+        totalNodes += stats.nodes;
+    const auto probes = ttMisses + ttHits + ttCollisions;
+
+    _out << "search profile: " << totalNodes << " nodes\n"
+         << std::fixed << std::setprecision(3)
+         << "tt probes " << probes << "  hit rate " << ratio(ttHits, probes)
+         << "  collision rate " << ratio(ttCollisions, probes) << '\n'
+         << "time: movegen " << moveGenerationNs / 1e6 << " ms, eval " << evaluationNs / 1e6
+         << " ms, other " << (_searchNs - moveGenerationNs - evaluationNs) / 1e6 << " ms\n"
+         << " ply      nodes  branching  searched  cutoffs  first-move\n";
+
+    for (int ply = 0; ply < maxPly; ++ply) {
+        const auto& stats = plies[ply];
+        if(!stats.nodes)
+            continue;
+        _out << std::setw(4) << ply << ' ' << std::setw(10) << stats.nodes
+             << ' ' << std::setw(10) << ratio(stats.movesGenerated, stats.nodes)
+             << ' ' << std::setw(9) << ratio(stats.childrenSearched, stats.nodes)
+             << ' ' << std::setw(8) << stats.cutoffs
+             << ' ' << std::setw(11) << ratio(stats.firstMoveCutoffs, stats.cutoffs) << '\n';
+    }
+}
+
+void SearchProfiler::dumpTree(std::ostream &_out) const
+{
+    // One sampled node per line, indented by ply, so the dump reads as a sparse tree.
+    for (const auto& sample : samples) {
+        _out << std::string(static_cast<size_t>(sample.ply) * 2, ' ')
+             << "ply=" << sample.ply << " depth=" << sample.depth
+             << " window=[" << sample.alpha << ',' << sample.beta << "] score=" << sample.score
+             << " key=" << std::hex << sample.key << std::dec << '\n';
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <array>
+#include <ostream>
+#include <vector>
+
+// Only compiled into builds configured with CHECKERS_SEARCH_PROFILE; release builds never define it.
+class SearchProfiler
+{
+public:
+    static constexpr int maxPly = 128;
+
+    enum class Probe { Miss, Hit, Collision };
+
+    struct PlyStats
+    {
+        quint64 nodes = 0;
+        quint64 movesGenerated = 0;
+        quint64 childrenSearched = 0;
+        quint64 cutoffs = 0;
+        quint64 firstMoveCutoffs = 0;
+    };
+
+    struct Sample
+    {
+        int ply;
+        int depth;
+        int alpha;
+        int beta;
+        int score;
+        quint64 key;
+    };
+
+    explicit SearchProfiler(const quint64 _sampleInterval = 4096);
+
+    void reset();
+
+    void enterNode(int _ply) { ++plies[clampPly(_ply)].nodes; }
+    void generated(int _ply, int _moves) { plies[clampPly(_ply)].movesGenerated += _moves; }
+    void searchedChild(int _ply) { ++plies[clampPly(_ply)].childrenSearched; }
+    void cutoff(int _ply, int _moveNumber);
+    void probe(Probe _result);
+    void addMoveGenerationTime(qint64 _ns) { moveGenerationNs += _ns; }
+    void addEvaluationTime(qint64 _ns) { evaluationNs += _ns; }
+    void sample(int _ply, int _depth, int _alpha, int _beta, int _score, quint64 _key);
+
+    void report(std::ostream &_out, qint64 _searchNs) const;
+    void dumpTree(std::ostream &_out) const;
+
+private:
+    static int clampPly(int _ply) { return _ply < maxPly ? _ply : maxPly - 1; }
+
+private:
+    std::array<PlyStats, maxPly> plies;
+    std::vector<Sample> samples;
+    quint64 sampleInterval;
+    quint64 sampleCounter;
+    quint64 ttMisses;
+    quint64 ttHits;
+    quint64 ttCollisions;
+    qint64 moveGenerationNs;
+    qint64 evaluationNs;
+};
@@ -0,0 +1,138 @@
+#include "position.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QTextStream>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ClientStats
+{
+    std::atomic<quint64> requests{0};
+    std::atomic<quint64> moves{0};
+    std::atomic<quint64> finished{0};
+    std::atomic<quint64> errors{0};
+};
+
+QByteArray request(QLocalSocket &_socket, const QByteArray &_line)
+{
+    _socket.write(_line + '\n');
+    _socket.flush();
+    while(!_socket.canReadLine()) {
+        if(!_socket.waitForReadyRead(10000))
+            return "error timeout";
+    }
+    return _socket.readLine().trimmed();
+}
+
+void playSessions(const QString &_name, const int _sessions, const int _maxPlies, const unsigned _seed, ClientStats &_stats)
+{
+    QLocalSocket socket;
+    socket.connectToServer(_name);
+    if(!socket.waitForConnected(5000)) {
+        ++_stats.errors;
+        return;
+    }
+
+    std::mt19937 random(_seed);
+    std::vector<QByteArray> ids;
+    for (int i = 0; i < _sessions; ++i) {
+        const auto reply = request(socket, "new");
+        ++_stats.requests;
+        if(!reply.startsWith("ok ")) {
+            ++_stats.errors;
+            continue;
+        }
+        ids.push_back(reply.split(' ').value(1));
+    }
+
+    // Round-robin over the sessions so the server sees interleaved traffic.
+    std::vector<bool> done(ids.size(), false);
+    for (int ply = 0; ply < _maxPlies; ++ply) {
+        bool anyActive = false;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if(done[i])
+                continue;
+
+            const auto moves = request(socket, "moves " + ids[i]).split(' ');
+            ++_stats.requests;
+            if(moves.size() < 2 || moves[0] != "ok") {
+                done[i] = true;
+                ++_stats.finished;
+                continue;
+            }
+
+            std::uniform_int_distribution<int> pick(1, moves.size() - 1);
+            const auto reply = request(socket, "play " + ids[i] + ' ' + moves[pick(random)]);
+            ++_stats.requests;
+            if(!reply.startsWith("ok")) {
+                ++_stats.errors;
+                done[i] = true;
+                continue;
+            }
+            ++_stats.moves;
+            if(reply.contains(" result ")) {
+                done[i] = true;
+                ++_stats.finished;
+                continue;
+            }
+            anyActive = true;
+        }
+        if(!anyActive)
+            break;
+    }
+
+    for (const auto& id : ids) {
+        request(socket, "close " + id);
+        ++_stats.requests;
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CheckersClient");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Stand-in client that plays random games against CheckersServer.");
+    parser.addHelpOption();
+    QCommandLineOption nameOption("name", "Local socket name.", "name", "checkers-server");
+    QCommandLineOption connectionsOption("connections", "Parallel connections.", "count", "4");
+    QCommandLineOption sessionsOption("sessions", "Sessions opened per connection.", "count", "256");
+    QCommandLineOption pliesOption("plies", "Maximum plies per game.", "count", "200");
+    QCommandLineOption seedOption("seed", "Random seed.", "seed", "1");
+    parser.addOptions({ nameOption, connectionsOption, sessionsOption, pliesOption, seedOption });
+    parser.process(app);
+
+    const auto connections = qMax(1, parser.value(connectionsOption).toInt());
+    const auto sessions = qMax(1, parser.value(sessionsOption).toInt());
+    const auto plies = qMax(1, parser.value(pliesOption).toInt());
+    const auto seed = parser.value(seedOption).toUInt();
+
+    ClientStats stats;
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < connections; ++i)
+        workers.emplace_back(playSessions, parser.value(nameOption), sessions, plies, seed + i, std::ref(stats));
+    for (auto& worker : workers)
+        worker.join();
+
+    const auto seconds = timer.nsecsElapsed() / 1e9;
+    QTextStream out(stdout);
+    out << "requests " << stats.requests.load() << " (" << qRound(stats.requests.load() / seconds) << "/s)\n"
+        << "moves    " << stats.moves.load() << '\n'
+        << "finished " << stats.finished.load() << '\n'
+        << "errors   " << stats.errors.load() << '\n';
+    return stats.errors.load() == 0 ? 0 : 1;
+}
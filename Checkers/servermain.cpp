@@ -0,0 +1,31 @@
+#include "gameserver.hpp"
+#include "metricsendpoint.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QThread>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CheckersServer");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Hosts many independent checkers games behind a local socket.");
+    parser.addHelpOption();
+    QCommandLineOption nameOption("name", "Local socket name.", "name", "checkers-server");
+    QCommandLineOption threadsOption("threads", "Worker threads handling turns.", "count",
+                                     QString::number(QThread::idealThreadCount()));
+    parser.addOptions({ nameOption, threadsOption });
+    parser.process(app);
+
+    MetricsEndpoint::setupFromEnvironment(&app);
+
+    GameServer server(qMax(1, parser.value(threadsOption).toInt()));
+    if(!server.listen(parser.value(nameOption))) {
+        qCritical() << "Unable to listen on" << parser.value(nameOption);
+        return 1;
+    }
+    return app.exec();
+}
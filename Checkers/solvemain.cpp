@@ -0,0 +1,54 @@
+#include "pnsolver.hpp"
+#include "metricsendpoint.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CheckersSolve");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decides positions exactly with proof-number search.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("fen", "Positions to solve, e.g. W:W18,22:B9,14");
+    QCommandLineOption edgeOption("edge", "Board edge size.", "size", "8");
+    QCommandLineOption memoryOption("memory", "Node table size in megabytes.", "mb", QString::number(PnSolver::defaultMemoryMegabytes));
+    QCommandLineOption nodesOption("nodes", "Node budget per proof.", "count", "10000000");
+    QCommandLineOption pliesOption("max-plies", "Horizon after which a line still open makes the result undecided.", "plies", "80");
+    parser.addOptions({ edgeOption, memoryOption, nodesOption, pliesOption });
+    parser.process(app);
+
+    MetricsThread metrics;
+
+    PnSolver::Limits limits;
+    limits.memoryMegabytes = parser.value(memoryOption).toInt();
+    limits.nodes = parser.value(nodesOption).toULongLong();
+    limits.maxPlies = parser.value(pliesOption).toInt();
+    const auto edge = parser.value(edgeOption).toInt();
+
+    QTextStream out(stdout);
+    int failures = 0;
+    for (const auto& fen : parser.positionalArguments()) {
+        Position position;
+        if(!Position::fromFen(fen.toStdString(), position, edge)) {
+            out << fen << " invalid position\n";
+            ++failures;
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        PnSolver solver(limits);
+        const auto result = solver.solve(position);
+
+        out << fen << ' ' << PnSolver::outcomeName(result.outcome);
+        if(result.hasMove)
+            out << " move=" << QString::fromStdString(position.moveToString(result.bestMove));
+        out << " nodes=" << result.nodes << " ms=" << timer.elapsed() << '\n';
+    }
+    return failures == 0 ? 0 : 1;
+}
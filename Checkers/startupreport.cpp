@@ -0,0 +1,99 @@
+#include "startupreport.hpp"
+#include "metrics.hpp"
+
+#include <QElapsedTimer>
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Phase
+{
+    const char *name;
+    qint64 endNs;
+};
+
+struct State
+{
+    QElapsedTimer clock;
+    std::vector<Phase> phases;
+    qint64 firstFrameNs = -1;
+    bool finished = false;
+};
+
+State& state()
+{
+    static State instance;
+    return instance;
+}
+
+const Metrics::Histogram firstFrame("checkers_startup_first_frame_seconds", "Time from process start to the first painted frame.");
+
+}
+
+void StartupReport::begin()
+{
+    state().clock.start();
+    state().phases.clear();
+}
+
+void StartupReport::mark(const char *_phase)
+{
+    if(!state().clock.isValid())
+        begin();
+    state().phases.push_back({ _phase, elapsedNs() });
+}
+
+void StartupReport::markFirstFrame()
+{
+    if(hasFirstFrame())
+        return;
+    mark("first frame");
+    state().firstFrameNs = elapsedNs();
+    firstFrame.observe(state().firstFrameNs);
+}
+
+qint64 StartupReport::elapsedNs()
+{
+    return state().clock.isValid() ? state().clock.nsecsElapsed() : 0;
+}
+
+bool StartupReport::hasFirstFrame()
+{
+    return state().firstFrameNs >= 0;
+}
+
+QByteArray StartupReport::text()
+{
+    QByteArray result("startup phase               ms     total ms\n");
+    qint64 previous = 0;
+    for (const auto& phase : state().phases) {
+        char line[96];
+        std::snprintf(line, sizeof(line), "%-22s %9.2f %12.2f\n", phase.name,
+                      (phase.endNs - previous) / 1e6, phase.endNs / 1e6);
+        result += line;
+        previous = phase.endNs;
+    }
+    if(hasFirstFrame())
+        result += "time to first frame: " + QByteArray::number(state().firstFrameNs / 1e6, 'f', 2) + " ms\n";
+    return result;
+}
+
+void StartupReport::finish()
+{
+    if(state().finished)
+        return;
+    state().finished = true;
+
+    qint64 previous = 0;
+    for (const auto& phase : state().phases) {
+        const Metrics::Histogram duration("checkers_startup_phase_seconds", "Duration of one application start phase.",
+                                          QByteArray("phase=\"") + phase.name + '"');
+        duration.observe(phase.endNs - previous);
+        previous = phase.endNs;
+    }
+
+    if(qEnvironmentVariableIsSet("CHECKERS_STARTUP_REPORT"))
+        std::fputs(text().constData(), stderr);
+}
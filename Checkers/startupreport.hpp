@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+
+// Wall-clock breakdown of application start. Phases are marked in order from the GUI thread;
+// each one covers the time since the previous mark.
+class StartupReport
+{
+public:
+    static void begin();
+    static void mark(const char *_phase);
+    static void markFirstFrame();
+    static qint64 elapsedNs();
+    static bool hasFirstFrame();
+
+    static QByteArray text();
+    // Publishes the phases as metrics and prints them when CHECKERS_STARTUP_REPORT is set.
+    static void finish();
+};
@@ -0,0 +1,126 @@
+#include "trace.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+#include <array>
+#include <chrono>
+
+namespace {
+
+// A seqlock: the fields are relaxed atomics so a reader racing a writer sees stale or mixed
+// values rather than undefined behaviour, and the sequence read before and after tells it which.
+struct Slot
+{
+    std::atomic<quint64> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<qint64> beginNs{0};
+    std::atomic<qint64> durationNs{0};
+    std::atomic<int> threadId{0};
+};
+
+struct Event
+{
+    const char *name;
+    qint64 beginNs;
+    qint64 durationNs;
+    int threadId;
+};
+
+// Copies the slot holding ticket; false when it holds another ticket or was rewritten meanwhile.
+bool readSlot(const Slot &_slot, const quint64 _ticket, Event &_event)
+{
+    if(_slot.sequence.load(std::memory_order_acquire) != _ticket + 1)
+        return false;
+    _event.name = _slot.name.load(std::memory_order_relaxed);
+    _event.beginNs = _slot.beginNs.load(std::memory_order_relaxed);
+    _event.durationNs = _slot.durationNs.load(std::memory_order_relaxed);
+    _event.threadId = _slot.threadId.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return _slot.sequence.load(std::memory_order_relaxed) == _ticket + 1;
+}
+
+std::array<Slot, Trace::capacity> ring;
+std::atomic<quint64> head{0};
+std::atomic<int> threadCounter{0};
+
+int currentThreadId()
+{
+    thread_local const int id = ++threadCounter;
+    return id;
+}
+
+}
+
+std::atomic<bool> Trace::enabled{false};
+
+void Trace::setEnabled(bool _value)
+{
+    enabled.store(_value, std::memory_order_relaxed);
+}
+
+qint64 Trace::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char *_name, qint64 _beginNs, qint64 _endNs)
+{
+    // Slots are claimed with a single fetch_add. The sequence is cleared before the fields are
+    // written and published after them, so an exporter discards a slot rewritten under it.
+    const auto ticket = head.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = ring[ticket % capacity];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(_name, std::memory_order_relaxed);
+    slot.beginNs.store(_beginNs, std::memory_order_relaxed);
+    slot.durationNs.store(_endNs - _beginNs, std::memory_order_relaxed);
+    slot.threadId.store(currentThreadId(), std::memory_order_relaxed);
+    slot.sequence.store(ticket + 1, std::memory_order_release);
+}
+
+void Trace::clear()
+{
+    for (auto& slot : ring)
+        slot.sequence.store(0, std::memory_order_relaxed);
+    head.store(0, std::memory_order_relaxed);
+}
+
+bool Trace::exportChromeJson(const QString &_fileName)
+{
+    QFile file(_fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    QTextStream out(&file);
+    out << "{\"traceEvents\":[";
+
+    const auto end = head.load(std::memory_order_acquire);
+    const auto begin = end > static_cast<quint64>(capacity) ? end - capacity : 0;
+    bool first = true;
+    for (auto ticket = begin; ticket < end; ++ticket) {
+        Event event;
+        if(!readSlot(ring[ticket % capacity], ticket, event))
+            continue;
+
+        if(!first)
+            out << ',';
+        first = false;
+        out << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1"
+            << ",\"tid\":" << event.threadId
+            << ",\"ts\":" << QString::number(event.beginNs / 1000.0, 'f', 3)
+            << ",\"dur\":" << QString::number(event.durationNs / 1000.0, 'f', 3) << '}';
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return true;
+}
+
+QString Trace::defaultFileName()
+{
+    const auto fromEnv = qEnvironmentVariable("CHECKERS_TRACE");
+    if(!fromEnv.isEmpty())
+        return fromEnv;
+    return QDir::temp().filePath("checkers-trace.json");
+}
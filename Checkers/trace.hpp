@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+
+#include <atomic>
+
+#define CHECKERS_TRACE_CONCAT_IMPL(a, b) a##b
+#define CHECKERS_TRACE_CONCAT(a, b) CHECKERS_TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SPAN(name) Trace::Span CHECKERS_TRACE_CONCAT(traceSpan, __LINE__)(name)
+
+class Trace
+{
+public:
+    static constexpr int capacity = 1 << 16;
+
+    class Span
+    {
+    public:
+        explicit Span(const char *_name)
+            : name(_name)
+            , begin(Trace::isEnabled() ? Trace::now() : -1)
+        {}
+        ~Span()
+        {
+            if(begin >= 0)
+                Trace::record(name, begin, Trace::now());
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char *name;
+        const qint64 begin;
+    };
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool _value);
+
+    static qint64 now();
+    static void record(const char *_name, qint64 _beginNs, qint64 _endNs);
+    static void clear();
+
+    static bool exportChromeJson(const QString &_fileName);
+    static QString defaultFileName();
+
+private:
+    Trace() = delete;
+
+    static std::atomic<bool> enabled;
+};
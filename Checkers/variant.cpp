@@ -0,0 +1,39 @@
+#include "variant.hpp"
+
+#include <array>
+
+namespace {
+
+template<Variant V>
+constexpr VariantInfo infoOf(const char *_name)
+{
+    return { _name, Rules<V>::edge, Rules<V>::capture, Rules<V>::menCaptureBackward,
+             Rules<V>::flyingKings, Rules<V>::capturedPiecesBlock, Rules<V>::promotion, Rules<V>::quietMoveLimit };
+}
+
+const std::array<VariantInfo, 6> variants {{
+    infoOf<Variant::Classic>("classic"),
+    infoOf<Variant::American>("american"),
+    infoOf<Variant::Russian>("russian"),
+    infoOf<Variant::Brazilian>("brazilian"),
+    infoOf<Variant::International>("international"),
+    infoOf<Variant::Pool>("pool"),
+}};
+
+}
+
+const VariantInfo &variantInfo(const Variant _variant)
+{
+    return variants[static_cast<size_t>(_variant)];
+}
+
+bool variantFromName(const std::string &_name, Variant &_variant)
+{
+    for (size_t i = 0; i < variants.size(); ++i) {
+        if(_name == variants[i].name) {
+            _variant = static_cast<Variant>(i);
+            return true;
+        }
+    }
+    return false;
+}
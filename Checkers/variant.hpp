@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <string>
+
+enum class Variant : quint8 { Classic, American, Russian, Brazilian, International, Pool };
+
+enum class CaptureRule : quint8 { Free, Majority };
+// What happens when a man reaches the far row in the middle of a capture; None never crowns.
+enum class Promotion : quint8 { None, AtEnd, EndsCapture, ContinueAsKing };
+
+// Compile-time rule sets; each variant gets its own instantiation of the move generator.
+// quietMoveLimit is the number of moves per side without a capture or a man move that draws.
+template<Variant V> struct Rules;
+
+// The rules of the original widget game: men capture backwards, captured checkers leave the
+// board as soon as they are jumped and men are never crowned, since the widget King cannot move.
+template<> struct Rules<Variant::Classic>
+{
+    static constexpr int edge = 8;
+    static constexpr CaptureRule capture = CaptureRule::Free;
+    static constexpr bool menCaptureBackward = true;
+    static constexpr bool flyingKings = false;
+    static constexpr bool capturedPiecesBlock = false;
+    static constexpr Promotion promotion = Promotion::None;
+    static constexpr int quietMoveLimit = 40;
+};
+
+template<> struct Rules<Variant::American>
+{
+    static constexpr int edge = 8;
+    static constexpr CaptureRule capture = CaptureRule::Free;
+    static constexpr bool menCaptureBackward = false;
+    static constexpr bool flyingKings = false;
+    static constexpr bool capturedPiecesBlock = true;
+    static constexpr Promotion promotion = Promotion::EndsCapture;
+    static constexpr int quietMoveLimit = 40;
+};
+
+template<> struct Rules<Variant::Russian>
+{
+    static constexpr int edge = 8;
+    static constexpr CaptureRule capture = CaptureRule::Free;
+    static constexpr bool menCaptureBackward = true;
+    static constexpr bool flyingKings = true;
+    static constexpr bool capturedPiecesBlock = true;
+    static constexpr Promotion promotion = Promotion::ContinueAsKing;
+    static constexpr int quietMoveLimit = 15;
+};
+
+template<> struct Rules<Variant::Brazilian>
+{
+    static constexpr int edge = 8;
+    static constexpr CaptureRule capture = CaptureRule::Majority;
+    static constexpr bool menCaptureBackward = true;
+    static constexpr bool flyingKings = true;
+    static constexpr bool capturedPiecesBlock = true;
+    static constexpr Promotion promotion = Promotion::AtEnd;
+    static constexpr int quietMoveLimit = 20;
+};
+
+template<> struct Rules<Variant::International>
+{
+    static constexpr int edge = 10;
+    static constexpr CaptureRule capture = CaptureRule::Majority;
+    static constexpr bool menCaptureBackward = true;
+    static constexpr bool flyingKings = true;
+    static constexpr bool capturedPiecesBlock = true;
+    static constexpr Promotion promotion = Promotion::AtEnd;
+    static constexpr int quietMoveLimit = 25;
+};
+
+template<> struct Rules<Variant::Pool>
+{
+    static constexpr int edge = 8;
+    static constexpr CaptureRule capture = CaptureRule::Free;
+    static constexpr bool menCaptureBackward = true;
+    static constexpr bool flyingKings = true;
+    static constexpr bool capturedPiecesBlock = true;
+    static constexpr Promotion promotion = Promotion::AtEnd;
+    static constexpr int quietMoveLimit = 40;
+};
+
+// The same settings at runtime, for code outside the generator's inner loops.
+struct VariantInfo
+{
+    const char *name;
+    int edge;
+    CaptureRule capture;
+    bool menCaptureBackward;
+    bool flyingKings;
+    bool capturedPiecesBlock;
+    Promotion promotion;
+    int quietMoveLimit;
+};
+
+const VariantInfo& variantInfo(const Variant _variant);
+bool variantFromName(const std::string &_name, Variant &_variant);
@@ -0,0 +1,253 @@
+#include "workqueue.hpp"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace {
+const char *pendingDir = "pending";
+const char *claimedDir = "claimed";
+const char *doneDir = "done";
+const char *failedDir = "failed";
+const char *checkpointDir = "checkpoints";
+
+bool touch(const QString &_fileName)
+{
+    QFile file(_fileName);
+    return file.open(QIODevice::ReadWrite) && file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+}
+}
+
+WorkQueue::WorkQueue(const QString &_root, const int _maxAttempts)
+    : root(_root)
+    , maxAttempts(_maxAttempts)
+{}
+
+bool WorkQueue::initialize()
+{
+    for (auto dir : { pendingDir, claimedDir, doneDir, failedDir, checkpointDir }) {
+        if(!root.mkpath(dir))
+            return false;
+    }
+    return true;
+}
+
+QString WorkQueue::path(const char *_state, const QString &_file) const
+{
+    return root.filePath(QString::fromLatin1(_state) + '/' + _file);
+}
+
+bool WorkQueue::writeJson(const QString &_fileName, const QJsonObject &_object)
+{
+    // QSaveFile writes a temporary file and renames it into place on commit.
+    QSaveFile file(_fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(_object).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+bool WorkQueue::readJson(const QString &_fileName, QJsonObject &_object)
+{
+    QFile file(_fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    const auto document = QJsonDocument::fromJson(file.readAll());
+    if(!document.isObject())
+        return false;
+    _object = document.object();
+    return true;
+}
+
+QJsonObject WorkQueue::toJson(const Unit &_unit)
+{
+    return QJsonObject {
+        { "id", _unit.id },
+        { "kind", _unit.kind },
+        { "parameters", _unit.parameters },
+        { "attempts", _unit.attempts }
+    };
+}
+
+WorkQueue::Unit WorkQueue::fromJson(const QJsonObject &_object)
+{
+    Unit unit;
+    unit.id = _object.value("id").toString();
+    unit.kind = _object.value("kind").toString();
+    unit.parameters = _object.value("parameters").toObject();
+    unit.attempts = _object.value("attempts").toInt();
+    return unit;
+}
+
+bool WorkQueue::submit(const Unit &_unit)
+{
+    if(QFileInfo::exists(path(doneDir, _unit.id + ".json")))
+        return true;
+    return writeJson(path(pendingDir, _unit.id + ".json"), toJson(_unit));
+}
+
+bool WorkQueue::claim(const QString &_worker, Unit &_unit)
+{
+    QDir pending(root.filePath(pendingDir));
+    const auto files = pending.entryList({ "*.json" }, QDir::Files, QDir::Name);
+
+    for (const auto& file : files) {
+        // rename() is atomic: exactly one worker moves a given unit out of pending/. The unit's
+        // time is reset so that, until the lease exists, requeueExpired() measures from the claim.
+        const auto claimed = path(claimedDir, file);
+        if(!QFile::rename(pending.filePath(file), claimed))
+            continue;
+        touch(claimed);
+
+        QJsonObject object;
+        if(!readJson(claimed, object)) {
+            QFile::rename(claimed, path(failedDir, file));
+            continue;
+        }
+
+        const auto id = QFileInfo(file).completeBaseName();
+        QJsonObject lease { { "worker", _worker }, { "since", QDateTime::currentSecsSinceEpoch() } };
+        if(!writeJson(path(claimedDir, id + ".lease"), lease)) {
+            QFile::rename(claimed, pending.filePath(file));
+            return false;
+        }
+
+        _unit = fromJson(object);
+        _unit.worker = _worker;
+        return true;
+    }
+    return false;
+}
+
+bool WorkQueue::holdsLease(const Unit &_unit) const
+{
+    QJsonObject lease;
+    return readJson(path(claimedDir, _unit.id + ".lease"), lease) && lease.value("worker").toString() == _unit.worker;
+}
+
+bool WorkQueue::heartbeat(const Unit &_unit)
+{
+    return holdsLease(_unit) && touch(path(claimedDir, _unit.id + ".lease"));
+}
+
+// A worker whose lease expired and was requeued no longer owns the unit; its result is dropped
+// rather than removing the claim of the worker that took the unit over.
+bool WorkQueue::complete(const Unit &_unit, const QJsonObject &_result)
+{
+    if(!holdsLease(_unit))
+        return false;
+
+    auto object = toJson(_unit);
+    object.insert("result", _result);
+    if(!writeJson(path(doneDir, _unit.id + ".json"), object))
+        return false;
+
+    QFile::remove(path(claimedDir, _unit.id + ".json"));
+    QFile::remove(path(claimedDir, _unit.id + ".lease"));
+    QFile::remove(path(checkpointDir, _unit.id + ".json"));
+    return true;
+}
+
+bool WorkQueue::fail(const Unit &_unit, const QString &_error)
+{
+    if(!holdsLease(_unit))
+        return false;
+
+    auto retry = _unit;
+    ++retry.attempts;
+    auto object = toJson(retry);
+    object.insert("error", _error);
+
+    const auto target = retry.attempts < maxAttempts ? pendingDir : failedDir;
+    if(!writeJson(path(target, _unit.id + ".json"), object))
+        return false;
+
+    QFile::remove(path(claimedDir, _unit.id + ".json"));
+    QFile::remove(path(claimedDir, _unit.id + ".lease"));
+    return true;
+}
+
+int WorkQueue::requeueExpired(const int _leaseSeconds)
+{
+    QDir claimed(root.filePath(claimedDir));
+    const auto now = QDateTime::currentDateTimeUtc();
+    int requeued = 0;
+
+    for (const auto& lease : claimed.entryInfoList({ "*.lease" }, QDir::Files)) {
+        if(lease.lastModified().toUTC().secsTo(now) >= _leaseSeconds)
+            requeued += requeue(lease.completeBaseName() + ".json", _leaseSeconds);
+    }
+
+    // A worker that died between claiming a unit and writing its lease leaves a unit without one.
+    for (const auto& unit : claimed.entryInfoList({ "*.json" }, QDir::Files)) {
+        if(!claimed.exists(unit.completeBaseName() + ".lease") && unit.lastModified().toUTC().secsTo(now) >= _leaseSeconds)
+            requeued += requeue(unit.fileName(), _leaseSeconds);
+    }
+    return requeued;
+}
+
+bool WorkQueue::requeue(const QString &_unitFile, const int _leaseSeconds)
+{
+    // The expired lease is renamed aside before the unit moves, so a worker that claims the unit
+    // as soon as it is pending never loses its new lease; a crash in between leaves a claimed unit
+    // without a lease, which requeueExpired() picks up. The checkpoint stays for the next worker.
+    const auto lease = path(claimedDir, QFileInfo(_unitFile).completeBaseName() + ".lease");
+    const auto stale = lease + ".stale-" + QString::number(QDateTime::currentMSecsSinceEpoch());
+    const bool hadLease = QFile::exists(lease);
+    if(hadLease) {
+        if(!QFile::rename(lease, stale))
+            return false;
+        // Another worker may have requeued and claimed the unit since the lease was found expired.
+        if(QFileInfo(stale).lastModified().toUTC().secsTo(QDateTime::currentDateTimeUtc()) < _leaseSeconds) {
+            if(!QFile::rename(stale, lease))
+                QFile::remove(stale);
+            return false;
+        }
+    }
+
+    const bool moved = QFile::rename(path(claimedDir, _unitFile), path(pendingDir, _unitFile));
+    if(hadLease)
+        QFile::remove(stale);
+    return moved;
+}
+
+bool WorkQueue::saveCheckpoint(const Unit &_unit, const QJsonObject &_state)
+{
+    heartbeat(_unit);
+    return writeJson(path(checkpointDir, _unit.id + ".json"), _state);
+}
+
+QJsonObject WorkQueue::loadCheckpoint(const Unit &_unit) const
+{
+    QJsonObject state;
+    readJson(path(checkpointDir, _unit.id + ".json"), state);
+    return state;
+}
+
+WorkQueue::Status WorkQueue::status() const
+{
+    auto count = [&](const char *_state) {
+        return QDir(root.filePath(_state)).entryList({ "*.json" }, QDir::Files).size();
+    };
+
+    Status result;
+    result.pending = count(pendingDir);
+    result.claimed = count(claimedDir);
+    result.done = count(doneDir);
+    result.failed = count(failedDir);
+    return result;
+}
+
+QList<QJsonObject> WorkQueue::results() const
+{
+    QList<QJsonObject> list;
+    QDir done(root.filePath(doneDir));
+    for (const auto& file : done.entryList({ "*.json" }, QDir::Files, QDir::Name)) {
+        QJsonObject object;
+        if(readJson(done.filePath(file), object))
+            list.append(object);
+    }
+    return list;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QDir>
+#include <QJsonObject>
+#include <QString>
+
+// Work units live as JSON files in a directory tree. Every state change is a
+// rename or an atomic file replacement, so several worker processes can share
+// one queue, including over a mounted network filesystem.
+class WorkQueue
+{
+public:
+    struct Unit
+    {
+        QString id;
+        QString kind;
+        QJsonObject parameters;
+        int attempts = 0;
+        // Set by claim(); only the worker named in the lease may heartbeat, complete or fail the unit.
+        QString worker;
+    };
+
+    struct Status
+    {
+        int pending = 0;
+        int claimed = 0;
+        int done = 0;
+        int failed = 0;
+    };
+
+    explicit WorkQueue(const QString &_root, const int _maxAttempts = 3);
+
+    bool initialize();
+
+    bool submit(const Unit &_unit);
+    bool claim(const QString &_worker, Unit &_unit);
+    bool heartbeat(const Unit &_unit);
+    bool complete(const Unit &_unit, const QJsonObject &_result);
+    bool fail(const Unit &_unit, const QString &_error);
+    int requeueExpired(const int _leaseSeconds);
+
+    bool saveCheckpoint(const Unit &_unit, const QJsonObject &_state);
+    QJsonObject loadCheckpoint(const Unit &_unit) const;
+
+    Status status() const;
+    QList<QJsonObject> results() const;
+
+private:
+    QString path(const char *_state, const QString &_file) const;
+    bool holdsLease(const Unit &_unit) const;
+    bool requeue(const QString &_unitFile, const int _leaseSeconds);
+    static bool writeJson(const QString &_fileName, const QJsonObject &_object);
+    static bool readJson(const QString &_fileName, QJsonObject &_object);
+    static QJsonObject toJson(const Unit &_unit);
+    static Unit fromJson(const QJsonObject &_object);
+
+private:
+    QDir root;
+    const int maxAttempts;
+};
@@ -0,0 +1,45 @@
+#include "zobrist.hpp"
+
+#include <array>
+
+namespace {
+
+struct KeyTable
+{
+    KeyTable()
+    {
+        quint64 state = 0x9E3779B97F4A7C15ull;
+        auto next = [&state]() {
+            auto z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        };
+
+        for (auto& square : pieces)
+            for (auto& key : square)
+                key = next();
+        side = next();
+    }
+
+    std::array<std::array<quint64, Zobrist::pieceKinds>, Zobrist::maxSquares> pieces;
+    quint64 side;
+};
+
+const KeyTable& keys()
+{
+    static const KeyTable table;
+    return table;
+}
+
+}
+
+quint64 Zobrist::pieceKey(const int _square, const Piece _piece)
+{
+    return keys().pieces[_square][static_cast<int>(_piece)];
+}
+
+quint64 Zobrist::sideKey()
+{
+    return keys().side;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QtGlobal>
+
+class Zobrist
+{
+public:
+    enum class Piece { WhiteMan, BlackMan, WhiteKing, BlackKing };
+
+    static constexpr int maxSquares = 50;
+    static constexpr int pieceKinds = 4;
+
+    static quint64 pieceKey(const int _square, const Piece _piece);
+    static quint64 sideKey();
+
+private:
+    Zobrist() = delete;
+};